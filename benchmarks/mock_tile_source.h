@@ -0,0 +1,76 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <array>
+#include <cstdlib>
+#include <format>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/image.h"
+#include "loaders/file_reader.h"
+#include "loaders/loader.h"
+#include "sources/tile_source.h"
+
+// Stands in for disk and decoder so that benchmarks measure tiling and
+// scheduling rather than I/O: every read returns a single byte and every
+// decode a 1x1 image.
+class MockFileReader : public FileReader {
+public:
+    [[nodiscard]] auto ReadBatch(std::span<const fs::path> paths) -> std::vector<ReadResult> override {
+        auto results = std::vector<ReadResult> {};
+        results.reserve(paths.size());
+        for (auto i = std::size_t {0}; i < paths.size(); ++i) {
+            results.emplace_back(FileData {
+                .bytes = FileBuffer {static_cast<unsigned char*>(std::malloc(1)), std::free},
+                .size = 1
+            });
+        }
+        return results;
+    }
+
+    [[nodiscard]] auto MaxBatchSize() const -> std::size_t override {
+        return 32;
+    }
+};
+
+class MockTileSource : public TileSource {
+public:
+    [[nodiscard]] auto Locate(const TileId& id) const -> fs::path override {
+        return std::format("{}.png", id);
+    }
+
+    [[nodiscard]] auto CreateReader() const -> std::unique_ptr<FileReader> override {
+        return std::make_unique<MockFileReader>();
+    }
+};
+
+class MockImageLoader : public Loader<Image> {
+public:
+    [[nodiscard]] static auto Create() -> std::shared_ptr<MockImageLoader> {
+        return std::shared_ptr<MockImageLoader>(new MockImageLoader());
+    }
+
+private:
+    MockImageLoader() = default;
+
+    [[nodiscard]] auto ValidFileExtensions() const -> std::span<const std::string_view> override {
+        static constexpr std::array<std::string_view, 1> kExtensions {".png"};
+        return kExtensions;
+    }
+
+    [[nodiscard]] auto DecodeImpl(
+        std::span<const unsigned char>,
+        const fs::path&
+    ) const -> std::shared_ptr<void> override {
+        return std::make_shared<Image>(
+            Image::Parameters {.width = 1, .height = 1, .depth = 4},
+            ImageData {static_cast<unsigned char*>(std::calloc(4, 1)), std::free}
+        );
+    }
+};
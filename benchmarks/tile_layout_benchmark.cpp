@@ -0,0 +1,87 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+// Compares culling one LOD stored the way Tile used to be, with the hot
+// bounds and flags interleaved with a texture's image pointer and GL id,
+// against the structure-of-arrays TileLevel.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <glm/vec2.hpp>
+
+#include "core/image.h"
+#include "tile.h"
+#include "tile_level.h"
+#include "types.h"
+
+static constexpr auto kTileExtent {256.0f};
+
+struct InterleavedTile {
+    TileId id;
+
+    glm::vec2 position;
+    glm::vec2 size;
+
+    float scale;
+
+    bool visible {false};
+
+    TileState state {TileState::Unloaded};
+
+    // What Texture2D carried.
+    std::shared_ptr<Image> image {nullptr};
+    unsigned int texture_id {0};
+    bool is_loaded {false};
+};
+
+// A 1024 x 1024 texel view in the middle of the level.
+static auto viewBounds(int tiles_per_side) -> Box2 {
+    const auto center = static_cast<float>(tiles_per_side) * kTileExtent / 2.0f;
+    return {
+        .min = {center - 512.0f, center - 512.0f},
+        .max = {center + 512.0f, center + 512.0f}
+    };
+}
+
+static auto BM_CullInterleaved(benchmark::State& state) {
+    const auto side = static_cast<int>(state.range(0));
+    auto tiles = std::vector<InterleavedTile> {};
+    tiles.reserve(static_cast<std::size_t>(side) * side);
+    for (auto y = 0; y < side; ++y) {
+        for (auto x = 0; x < side; ++x) {
+            tiles.emplace_back(InterleavedTile {
+                .id = {0, x, y},
+                .position = {static_cast<float>(x) * kTileExtent, static_cast<float>(y) * kTileExtent},
+                .size = glm::vec2 {kTileExtent},
+                .scale = 1.0f
+            });
+        }
+    }
+
+    const auto bounds = viewBounds(side);
+    for (auto _ : state) {
+        auto visible = std::size_t {0};
+        for (auto& tile : tiles) {
+            tile.visible = bounds.Intersects({.min = tile.position, .max = tile.position + tile.size});
+            visible += tile.visible;
+        }
+        benchmark::DoNotOptimize(visible);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tiles.size()));
+}
+BENCHMARK(BM_CullInterleaved)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+
+static auto BM_CullLevel(benchmark::State& state) {
+    const auto side = static_cast<int>(state.range(0));
+    auto level = TileLevel {0, side, side, kTileExtent};
+
+    const auto bounds = viewBounds(side);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(level.Cull(bounds));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(level.Size()));
+}
+BENCHMARK(BM_CullLevel)->RangeMultiplier(4)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
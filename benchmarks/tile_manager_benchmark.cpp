@@ -0,0 +1,159 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+// Microbenchmarks for the GL-free tiling logic on synthetic pyramids. The
+// argument is the number of LOD 0 tiles per side, so the largest run covers
+// 2048 x 2048 tiles at LOD 0 and about 5.6 million tiles overall.
+
+#include <memory>
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "core/orthographic_camera.h"
+#include "mock_tile_source.h"
+#include "tile_manager.h"
+#include "types.h"
+
+static constexpr auto kTileSize {256.0f};
+static constexpr auto kLods {8};
+static constexpr auto kWindowDims = Dimensions {1024.0f, 1024.0f};
+
+struct Scene {
+    std::unique_ptr<TileManager> tiles;
+    OrthographicCamera camera;
+    Dimensions texture_dims;
+};
+
+static auto makeScene(int tiles_per_side) -> Scene {
+    const auto extent = static_cast<float>(tiles_per_side) * kTileSize;
+    const auto texture_dims = Dimensions {extent, extent};
+
+    auto tiles = std::make_unique<TileManager>(
+        texture_dims,
+        kWindowDims,
+        kTileSize,
+        kLods,
+        std::make_shared<MockTileSource>(),
+        MockImageLoader::Create()
+    );
+
+    return {
+        .tiles = std::move(tiles),
+        .camera = OrthographicCamera {0.0f, extent, extent / kWindowDims.AspectRatio(), 0.0f, -1.0f, 1.0f},
+        .texture_dims = texture_dims
+    };
+}
+
+// Zooms in to one texel per pixel (LOD 0) and pans to the given view, in
+// units of one window. Views wrap around the image row by row.
+static auto moveCamera(Scene& scene, int view) -> void {
+    const auto views_per_row = static_cast<int>(scene.texture_dims.width / kWindowDims.width);
+    const auto x = static_cast<float>(view % views_per_row) * kWindowDims.width;
+    const auto y = static_cast<float>((view / views_per_row) % views_per_row) * kWindowDims.height;
+    const auto scale = kWindowDims.width / scene.texture_dims.width;
+
+    scene.camera.transform = glm::scale(
+        glm::translate(glm::mat4 {1.0f}, glm::vec3 {x, y, 0.0f}),
+        glm::vec3 {scale, scale, 1.0f}
+    );
+}
+
+// Plays the renderer's part: every decoded tile counts as uploaded.
+static auto completeDecoded(TileManager& tiles) -> void {
+    for (const auto& id : tiles.TakeDecoded()) {
+        auto& level = tiles.GetLevel(id.lod);
+        level.image[level.Index(id)] = nullptr;
+        tiles.MarkLoaded(id);
+    }
+}
+
+static auto settle(Scene& scene) -> void {
+    do {
+        scene.tiles->Update(scene.camera);
+        completeDecoded(*scene.tiles);
+    } while (scene.tiles->HasPendingWork());
+}
+
+static auto BM_ComputeLod(benchmark::State& state) {
+    auto scene = makeScene(64);
+    moveCamera(scene, 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scene.tiles->ComputeLod(scene.camera));
+    }
+}
+BENCHMARK(BM_ComputeLod);
+
+static auto BM_ComputeVisibleBounds(benchmark::State& state) {
+    auto scene = makeScene(64);
+    moveCamera(scene, 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scene.tiles->ComputeVisibleBounds(scene.camera));
+    }
+}
+BENCHMARK(BM_ComputeVisibleBounds);
+
+// A still camera over loaded tiles: Update() is all visibility culling.
+static auto BM_VisibilityCulling(benchmark::State& state) {
+    auto scene = makeScene(static_cast<int>(state.range(0)));
+    moveCamera(scene, 0);
+    settle(scene);
+
+    for (auto _ : state) {
+        scene.tiles->Update(scene.camera);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_VisibilityCulling)->RangeMultiplier(4)->Range(64, 2048)->Unit(benchmark::kMicrosecond);
+
+// A camera that moves to a fresh view every frame, so each Update() culls,
+// requests the newly visible tiles and collects the previous frame's loads.
+static auto BM_RequestScheduling(benchmark::State& state) {
+    auto scene = makeScene(static_cast<int>(state.range(0)));
+    auto view = 0;
+
+    for (auto _ : state) {
+        moveCamera(scene, view++);
+        scene.tiles->Update(scene.camera);
+
+        // Tiles are evicted as soon as they arrive so that revisited views
+        // issue requests again.
+        for (const auto& id : scene.tiles->TakeDecoded()) {
+            auto& level = scene.tiles->GetLevel(id.lod);
+            level.image[level.Index(id)] = nullptr;
+            level.state[level.Index(id)] = TileState::Unloaded;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RequestScheduling)->RangeMultiplier(4)->Range(64, 2048)->Unit(benchmark::kMicrosecond);
+
+// A still camera: the render list is reused as is.
+static auto BM_GetRenderList(benchmark::State& state) {
+    auto scene = makeScene(static_cast<int>(state.range(0)));
+    moveCamera(scene, 0);
+    settle(scene);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(scene.tiles->GetRenderList());
+    }
+}
+BENCHMARK(BM_GetRenderList)->RangeMultiplier(4)->Range(64, 2048)->Unit(benchmark::kMicrosecond);
+
+// A camera that pans every frame, so the list is rebuilt each time.
+static auto BM_RebuildRenderList(benchmark::State& state) {
+    auto scene = makeScene(static_cast<int>(state.range(0)));
+    moveCamera(scene, 0);
+    settle(scene);
+
+    const auto offset = glm::translate(glm::mat4 {1.0f}, glm::vec3 {kTileSize / 2.0f, 0.0f, 0.0f});
+    const auto origin = scene.camera.transform;
+    auto step = 0;
+    for (auto _ : state) {
+        scene.camera.transform = (step++ % 2 == 0) ? offset * origin : origin;
+        scene.tiles->Update(scene.camera);
+        benchmark::DoNotOptimize(scene.tiles->GetRenderList());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_RebuildRenderList)->RangeMultiplier(4)->Range(64, 2048)->Unit(benchmark::kMicrosecond);
@@ -2,7 +2,9 @@
 # All rights reserved.
 #
 # ShaderString.cmake
-# This function looks for GLSL files and converts them into C-style strings
+# This function looks for GLSL files and converts them into C-style strings.
+# Each header holds the shader as written and a release variant without its
+# `#pragma debug` and `#pragma optimize` lines; NDEBUG builds use the latter.
 
 function(ShaderString)
 
@@ -18,10 +20,16 @@ foreach(SHADER IN LISTS SHADERS)
 
     message("🎨 Writing shader ${FILENAME_NO_EXT}.h")
 
+    set(NAME _SHADER_${FILENAME_NO_EXT}${EXT})
+
     file(READ ${SHADER} CONTENTS)
-    file(WRITE ${HEADER_FILE} "#pragma once\n\nstatic const char* _SHADER_${FILENAME_NO_EXT}${EXT} = R\"(")
-    file(APPEND ${HEADER_FILE} "${CONTENTS}")
-    file(APPEND ${HEADER_FILE} ")\";")
+    string(REGEX REPLACE "#pragma (debug|optimize)\\([a-z]+\\)\r?\n" "" RELEASE_CONTENTS "${CONTENTS}")
+
+    file(WRITE ${HEADER_FILE} "#pragma once\n\n")
+    file(APPEND ${HEADER_FILE} "static constexpr const char* ${NAME}_debug = R\"(${CONTENTS})\";\n\n")
+    file(APPEND ${HEADER_FILE} "static constexpr const char* ${NAME}_release = R\"(${RELEASE_CONTENTS})\";\n\n")
+    file(APPEND ${HEADER_FILE} "#ifdef NDEBUG\nstatic const char* ${NAME} = ${NAME}_release;\n")
+    file(APPEND ${HEADER_FILE} "#else\nstatic const char* ${NAME} = ${NAME}_debug;\n#endif\n")
 endforeach()
 
 endfunction()
\ No newline at end of file
@@ -0,0 +1,87 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(std::size_t capacity) : capacity_(capacity) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Blocks while the queue is full. Returns false if the queue was closed.
+    auto Push(T item) -> bool {
+        auto lock = std::unique_lock {mutex_};
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) return false;
+        items_.emplace_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Never blocks. The item is left untouched when the queue is full.
+    auto TryPush(T&& item) -> bool {
+        auto lock = std::scoped_lock {mutex_};
+        if (closed_ || items_.size() >= capacity_) return false;
+        items_.emplace_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Blocks while the queue is empty. Returns nullopt once closed and drained.
+    auto Pop() -> std::optional<T> {
+        auto lock = std::unique_lock {mutex_};
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) return std::nullopt;
+        return Take();
+    }
+
+    auto TryPop() -> std::optional<T> {
+        auto lock = std::scoped_lock {mutex_};
+        if (items_.empty()) return std::nullopt;
+        return Take();
+    }
+
+    auto Close() -> void {
+        auto lock = std::scoped_lock {mutex_};
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    [[nodiscard]] auto Size() const -> std::size_t {
+        auto lock = std::scoped_lock {mutex_};
+        return items_.size();
+    }
+
+    [[nodiscard]] auto Capacity() const -> std::size_t {
+        return capacity_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+
+    std::deque<T> items_;
+
+    std::size_t capacity_ {0};
+
+    bool closed_ {false};
+
+    auto Take() -> T {
+        auto item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return item;
+    }
+};
@@ -0,0 +1,166 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "buffer_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+static constexpr std::size_t kSlabAlignment {4096};
+static constexpr std::size_t kHugePageBytes {2 * 1024 * 1024};
+
+auto BufferPool::Configure(const Config& config) -> void {
+    auto lock = std::scoped_lock {mutex_};
+    config_ = config;
+    ReleaseExcessSlabs();
+}
+
+auto BufferPool::Allocate(std::size_t size) -> void* {
+    // Leaves room to add the header and round up without wrapping.
+    if (size > std::numeric_limits<std::size_t>::max() - 2 * kHeaderBytes) return nullptr;
+
+    const auto size_class = SizeClassFor(size);
+    auto block = static_cast<void*>(nullptr);
+    if (size_class < 0) {
+        block = std::aligned_alloc(kHeaderBytes, (kHeaderBytes + size + kHeaderBytes - 1) / kHeaderBytes * kHeaderBytes);
+        if (block != nullptr && size > kSizeClasses.back()) ++oversize_in_use_;
+    } else {
+        block = TakeSlab(size_class);
+    }
+    if (block == nullptr) return nullptr;
+
+    new (block) Header {.size_class = size_class, .size = size};
+    return static_cast<unsigned char*>(block) + kHeaderBytes;
+}
+
+auto BufferPool::Reallocate(void* ptr, std::size_t size) -> void* {
+    if (ptr == nullptr) return Allocate(size);
+
+    const auto header = HeaderOf(ptr);
+    if (header->size_class >= 0 && size <= kSizeClasses[header->size_class]) {
+        header->size = size;
+        return ptr;
+    }
+
+    auto new_ptr = Allocate(size);
+    if (new_ptr != nullptr) {
+        std::memcpy(new_ptr, ptr, std::min(header->size, size));
+        Free(ptr);
+    }
+    return new_ptr;
+}
+
+auto BufferPool::Free(void* ptr) -> void {
+    if (ptr == nullptr) return;
+
+    const auto header = *HeaderOf(ptr);
+    const auto block = static_cast<void*>(HeaderOf(ptr));
+    if (header.size_class < 0) {
+        if (header.size > kSizeClasses.back()) --oversize_in_use_;
+        std::free(block);
+        return;
+    }
+
+    {
+        auto lock = std::scoped_lock {mutex_};
+        auto& slabs = classes_[header.size_class];
+        --slabs.in_use;
+        if (slabs.free_slabs.size() < config_.max_cached_slabs) {
+            slabs.free_slabs.emplace_back(block);
+            return;
+        }
+    }
+    ReleaseSlab(block);
+}
+
+auto BufferPool::GetStats() const -> Stats {
+    auto lock = std::scoped_lock {mutex_};
+    auto stats = Stats {};
+    stats.oversize_in_use = oversize_in_use_.load();
+    for (auto i = 0u; i < classes_.size(); ++i) {
+        const auto& slabs = classes_[i];
+        stats.classes.emplace_back(ClassStats {
+            .slab_size = kSizeClasses[i],
+            .slabs_in_use = slabs.in_use,
+            .slabs_cached = slabs.free_slabs.size(),
+            .hits = slabs.hits,
+            .misses = slabs.misses
+        });
+        stats.bytes_reserved += (slabs.in_use + slabs.free_slabs.size()) * kSizeClasses[i];
+    }
+    return stats;
+}
+
+auto BufferPool::TakeSlab(int size_class) -> void* {
+    auto huge_pages = false;
+    {
+        auto lock = std::scoped_lock {mutex_};
+        auto& slabs = classes_[size_class];
+        ++slabs.in_use;
+        if (!slabs.free_slabs.empty()) {
+            const auto slab = slabs.free_slabs.back();
+            slabs.free_slabs.pop_back();
+            ++slabs.hits;
+            return slab;
+        }
+        ++slabs.misses;
+        huge_pages = config_.use_huge_pages;
+    }
+
+    // New slabs are allocated outside the lock, which the other classes
+    // and every free share.
+    auto slab = AllocateSlab(kHeaderBytes + kSizeClasses[size_class], huge_pages);
+    if (slab == nullptr) {
+        auto lock = std::scoped_lock {mutex_};
+        --classes_[size_class].in_use;
+    }
+    return slab;
+}
+
+auto BufferPool::AllocateSlab(std::size_t size, [[maybe_unused]] bool huge_pages) -> void* {
+#ifdef __linux__
+    if (huge_pages && size >= kHugePageBytes) {
+        // Huge-page alignment lets the kernel back the slab with THP; the
+        // memory still comes from the heap so release stays uniform.
+        const auto rounded = (size + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+        auto ptr = std::aligned_alloc(kHugePageBytes, rounded);
+        if (ptr != nullptr) madvise(ptr, rounded, MADV_HUGEPAGE);
+        return ptr;
+    }
+#endif
+    return std::aligned_alloc(kSlabAlignment, (size + kSlabAlignment - 1) / kSlabAlignment * kSlabAlignment);
+}
+
+auto BufferPool::ReleaseSlab(void* slab) const -> void {
+    std::free(slab);
+}
+
+auto BufferPool::ReleaseExcessSlabs() -> void {
+    for (auto i = 0u; i < classes_.size(); ++i) {
+        auto& free_slabs = classes_[i].free_slabs;
+        while (free_slabs.size() > config_.max_cached_slabs) {
+            ReleaseSlab(free_slabs.back());
+            free_slabs.pop_back();
+        }
+    }
+}
+
+auto BufferPool::SizeClassFor(std::size_t size) -> int {
+    if (size < kMinPooledBytes) return -1;
+    for (auto i = 0u; i < kSizeClasses.size(); ++i) {
+        if (size <= kSizeClasses[i]) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+BufferPool::~BufferPool() {
+    config_.max_cached_slabs = 0;
+    ReleaseExcessSlabs();
+}
@@ -0,0 +1,116 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+class BufferPool {
+public:
+    // A decoded 1024x1024 RGBA tile, plus enough headroom for the raw zlib
+    // stream of the same tile (one filter byte per row) to share the class.
+    static constexpr std::size_t kTileBytes {1024 * 1024 * 4};
+    static constexpr std::size_t kTileSlabBytes {kTileBytes + 64 * 1024};
+
+    // Requests below this size are not worth a slab and go to the heap.
+    static constexpr std::size_t kMinPooledBytes {16 * 1024};
+
+    // Every buffer is preceded by a header recording where it came from, so
+    // that freeing it needs no lookup. Keeps the data 64-byte aligned.
+    static constexpr std::size_t kHeaderBytes {64};
+
+    static constexpr std::array<std::size_t, 4> kSizeClasses {
+        64 * 1024,
+        256 * 1024,
+        1024 * 1024,
+        kTileSlabBytes
+    };
+
+    struct Config {
+        // Free slabs retained per size class before returning memory to the OS.
+        std::size_t max_cached_slabs {64};
+
+        // Back tile-sized slabs with transparent huge pages where supported.
+        bool use_huge_pages {false};
+    };
+
+    struct ClassStats {
+        std::size_t slab_size {0};
+        std::size_t slabs_in_use {0};
+        std::size_t slabs_cached {0};
+        std::size_t hits {0};
+        std::size_t misses {0};
+    };
+
+    struct Stats {
+        std::vector<ClassStats> classes;
+        std::size_t oversize_in_use {0};
+        std::size_t bytes_reserved {0};
+    };
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    static auto Get() -> BufferPool& {
+        static auto instance = BufferPool {};
+        return instance;
+    }
+
+    auto Configure(const Config& config) -> void;
+
+    [[nodiscard]] auto Allocate(std::size_t size) -> void*;
+
+    // Only for buffers from Allocate(), as is Free().
+    [[nodiscard]] auto Reallocate(void* ptr, std::size_t size) -> void*;
+
+    auto Free(void* ptr) -> void;
+
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+private:
+    struct Header {
+        int size_class {-1};
+        std::size_t size {0};
+    };
+
+    static_assert(sizeof(Header) <= kHeaderBytes);
+
+    struct SizeClass {
+        std::vector<void*> free_slabs;
+        std::size_t in_use {0};
+        std::size_t hits {0};
+        std::size_t misses {0};
+    };
+
+    // Guards the slab lists only; buffers below and above the size classes
+    // never take it.
+    mutable std::mutex mutex_;
+
+    Config config_ {};
+
+    std::array<SizeClass, kSizeClasses.size()> classes_ {};
+
+    std::atomic<std::size_t> oversize_in_use_ {0};
+
+    BufferPool() = default;
+    ~BufferPool();
+
+    // A cached slab of the class, or a new one; header space included.
+    auto TakeSlab(int size_class) -> void*;
+
+    static auto AllocateSlab(std::size_t size, bool huge_pages) -> void*;
+
+    auto ReleaseSlab(void* slab) const -> void;
+
+    auto ReleaseExcessSlabs() -> void;
+
+    static auto SizeClassFor(std::size_t size) -> int;
+
+    static auto HeaderOf(void* ptr) -> Header* {
+        return reinterpret_cast<Header*>(static_cast<unsigned char*>(ptr) - kHeaderBytes);
+    }
+};
@@ -0,0 +1,52 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "frame_governor.h"
+
+#include <algorithm>
+
+#include <imgui.h>
+
+FrameGovernor::FrameGovernor(const Config& config) :
+    config_(config),
+    budget_({
+        .uploads = config.min_uploads,
+        .bytes = config.min_bytes,
+        .mipmaps = config.min_mipmaps
+    }),
+    average_ms_(config.target_ms) {}
+
+auto FrameGovernor::BeginFrame() -> void {
+    timer_.Reset();
+}
+
+auto FrameGovernor::EndFrame() -> void {
+    // Only the frame's own work is measured; time spent waiting for vsync
+    // or for input says nothing about how much more the frame can take.
+    const auto frame_ms = timer_.GetSeconds() * 1000.0;
+    average_ms_ += (frame_ms - average_ms_) * config_.smoothing;
+
+    const auto scale = [&](auto value, auto lo, auto hi) {
+        if (average_ms_ > config_.target_ms) {
+            value = value / 2;
+        } else if (average_ms_ < config_.target_ms * 0.5) {
+            value = value * 2;
+        } else if (average_ms_ < config_.target_ms * 0.8) {
+            value = value + std::max<decltype(value)>(1, lo / 4);
+        }
+        return std::clamp(value, lo, hi);
+    };
+
+    budget_.uploads = scale(budget_.uploads, config_.min_uploads, config_.max_uploads);
+    budget_.bytes = scale(budget_.bytes, config_.min_bytes, config_.max_bytes);
+    budget_.mipmaps = scale(budget_.mipmaps, config_.min_mipmaps, config_.max_mipmaps);
+}
+
+auto FrameGovernor::Debug() const -> void {
+    ImGui::Begin("Frame Governor");
+    ImGui::Text("Frame time: %.2f ms (target %.2f ms)", average_ms_, config_.target_ms);
+    ImGui::Text("Uploads per frame: %d", budget_.uploads);
+    ImGui::Text("Upload bytes per frame: %.1f MB", budget_.bytes / (1024.0 * 1024.0));
+    ImGui::Text("Mipmaps per frame: %d", budget_.mipmaps);
+    ImGui::End();
+}
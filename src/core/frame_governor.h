@@ -0,0 +1,73 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+#include "core/timer.h"
+
+struct UploadBudget {
+    int uploads {1};
+    std::size_t bytes {0};
+    int mipmaps {1};
+
+    // For work that has to finish before the first frame.
+    static constexpr auto Unlimited() -> UploadBudget {
+        return {
+            .uploads = std::numeric_limits<int>::max(),
+            .bytes = std::numeric_limits<std::size_t>::max(),
+            .mipmaps = std::numeric_limits<int>::max()
+        };
+    }
+};
+
+// Scales per-frame streaming work against a frame-time target. Frames over
+// target halve the budget; frames comfortably under it grow the budget,
+// doubling it when the loop is close to idle so a backlog clears quickly.
+class FrameGovernor {
+public:
+    struct Config {
+        double target_ms {16.6};
+
+        int min_uploads {1};
+        int max_uploads {32};
+
+        std::size_t min_bytes {4 * 1024 * 1024};
+        std::size_t max_bytes {128 * 1024 * 1024};
+
+        int min_mipmaps {1};
+        int max_mipmaps {32};
+
+        // Weight of the newest frame in the moving average.
+        double smoothing {0.2};
+    };
+
+    FrameGovernor() : FrameGovernor(Config {}) {}
+
+    explicit FrameGovernor(const Config& config);
+
+    auto BeginFrame() -> void;
+
+    auto EndFrame() -> void;
+
+    [[nodiscard]] auto Budget() const -> const UploadBudget& {
+        return budget_;
+    }
+
+    [[nodiscard]] auto AverageFrameMs() const -> double {
+        return average_ms_;
+    }
+
+    auto Debug() const -> void;
+
+private:
+    Config config_;
+
+    UploadBudget budget_;
+
+    Timer timer_ {};
+
+    double average_ms_ {0.0};
+};
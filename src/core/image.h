@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -16,19 +17,26 @@ public:
         int width {0};
         int height {0};
         int depth {0};
+        int bit_depth {8};
     };
 
     std::string filename {};
 
     unsigned int width {0};
     unsigned int height {0};
+
+    // Channels per pixel, as decoded: 1 (gray), 2 (gray and alpha), 3 or 4.
     unsigned int depth {0};
 
+    // Bits per channel, 8 or 16. 16-bit channels are in native byte order.
+    unsigned int bit_depth {8};
+
     Image(const Parameters& params, ImageData data) :
         filename(params.filename),
         width(params.width),
         height(params.height),
         depth(params.depth),
+        bit_depth(params.bit_depth),
         data_(std::move(data)) {}
 
     Image(Image&& other) noexcept :
@@ -36,6 +44,7 @@ public:
         width(other.width),
         height(other.height),
         depth(other.depth),
+        bit_depth(other.bit_depth),
         data_(std::move(other.data_))
     {
         Reset(other);
@@ -48,6 +57,7 @@ public:
             width = other.width;
             height = other.height;
             depth = other.depth;
+            bit_depth = other.bit_depth;
             Reset(other);
         }
         return *this;
@@ -59,6 +69,18 @@ public:
 
     [[nodiscard]] auto Data() const { return data_.get(); }
 
+    [[nodiscard]] auto BytesPerPixel() const -> std::size_t {
+        return static_cast<std::size_t>(depth) * (bit_depth / 8);
+    }
+
+    [[nodiscard]] auto RowBytes() const -> std::size_t {
+        return width * BytesPerPixel();
+    }
+
+    [[nodiscard]] auto Bytes() const -> std::size_t {
+        return height * RowBytes();
+    }
+
     ~Image() = default;
 
 private:
@@ -70,5 +92,6 @@ private:
         instance.width = 0;
         instance.height = 0;
         instance.depth = 0;
+        instance.bit_depth = 8;
     }
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "program_cache.h"
+
+#include <cstring>
+#include <format>
+#include <string_view>
+
+// Cached files start with the binary format the driver reported.
+static constexpr std::size_t kHeaderBytes {sizeof(GLenum)};
+
+static auto fnv1a(std::uint64_t hash, std::string_view bytes) -> std::uint64_t {
+    for (auto c : bytes) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static auto glString(GLenum name) -> std::string_view {
+    const auto value = reinterpret_cast<const char*>(glGetString(name));
+    return value != nullptr ? value : "";
+}
+
+auto ProgramCache::Enable(const fs::path& directory, std::uintmax_t max_bytes) -> void {
+    cache_ = std::make_unique<DiskCache>(directory, max_bytes);
+}
+
+auto ProgramCache::IsAvailable() -> bool {
+    if (cache_ == nullptr) return false;
+
+    if (driver_.empty()) {
+        // Some drivers support no binary formats at all.
+        auto formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        if (formats == 0) {
+            cache_.reset();
+            return false;
+        }
+        driver_ = std::format("{}\n{}\n{}", glString(GL_VENDOR), glString(GL_RENDERER), glString(GL_VERSION));
+    }
+    return true;
+}
+
+auto ProgramCache::Load(const std::vector<ShaderInfo>& shaders, GLuint program) -> bool {
+    if (!IsAvailable()) return false;
+
+    const auto data = cache_->Get(KeyFor(shaders));
+    if (!data || data->size <= kHeaderBytes) return false;
+
+    auto format = GLenum {0};
+    std::memcpy(&format, data->bytes.get(), kHeaderBytes);
+    glProgramBinary(
+        program,
+        format,
+        data->bytes.get() + kHeaderBytes,
+        static_cast<GLsizei>(data->size - kHeaderBytes)
+    );
+
+    auto success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    return success != 0;
+}
+
+auto ProgramCache::Store(const std::vector<ShaderInfo>& shaders, GLuint program) -> void {
+    if (!IsAvailable()) return;
+
+    auto length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    auto bytes = std::vector<unsigned char>(kHeaderBytes + static_cast<std::size_t>(length));
+    auto format = GLenum {0};
+    glGetProgramBinary(program, length, nullptr, &format, bytes.data() + kHeaderBytes);
+    std::memcpy(bytes.data(), &format, kHeaderBytes);
+
+    cache_->Put(KeyFor(shaders), bytes);
+}
+
+auto ProgramCache::KeyFor(const std::vector<ShaderInfo>& shaders) const -> std::string {
+    auto hash = fnv1a(14695981039346656037ull, driver_);
+    for (const auto& shader : shaders) {
+        const auto type = static_cast<char>(shader.type);
+        hash = fnv1a(hash, std::string_view {&type, 1});
+        hash = fnv1a(hash, shader.source);
+    }
+    return std::format("{:016x}.bin", hash);
+}
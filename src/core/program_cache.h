@@ -0,0 +1,50 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "core/shaders.h"
+#include "sources/disk_cache.h"
+
+namespace fs = std::filesystem;
+
+// Keeps linked program binaries on disk, keyed by a hash of the shader
+// sources and of the driver that built them, so that later launches skip
+// compiling and linking. Programs are built from source until Enable().
+class ProgramCache {
+public:
+    static auto Get() -> ProgramCache& {
+        static auto instance = ProgramCache {};
+        return instance;
+    }
+
+    auto Enable(const fs::path& directory, std::uintmax_t max_bytes = 32 * 1024 * 1024) -> void;
+
+    // Links the program from a cached binary. Returns false when there is
+    // none, or when the driver rejects it after an update.
+    auto Load(const std::vector<ShaderInfo>& shaders, GLuint program) -> bool;
+
+    // Saves a linked program built with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+    auto Store(const std::vector<ShaderInfo>& shaders, GLuint program) -> void;
+
+private:
+    std::unique_ptr<DiskCache> cache_;
+
+    // GL_VENDOR, GL_RENDERER and GL_VERSION, read on first use since
+    // Enable() may run before a context exists.
+    std::string driver_;
+
+    ProgramCache() = default;
+
+    auto IsAvailable() -> bool;
+
+    auto KeyFor(const std::vector<ShaderInfo>& shaders) const -> std::string;
+};
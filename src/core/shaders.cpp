@@ -7,9 +7,14 @@
 #include <iostream>
 #include <string>
 
+#include "core/program_cache.h"
+
 Shaders::Shaders(const std::vector<ShaderInfo>& shaders) {
     program_ = glCreateProgram();
 
+    auto& cache = ProgramCache::Get();
+    if (cache.Load(shaders, program_)) return;
+
     for (const auto& shader_info : shaders) {
         auto shader_id = glCreateShader(GetShaderType(shader_info.type));
         auto data = shader_info.source.data();
@@ -23,8 +28,11 @@ Shaders::Shaders(const std::vector<ShaderInfo>& shaders) {
         glDeleteShader(shader_id);
     }
 
+    glProgramParameteri(program_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(program_);
     CheckProgramLinkStatus();
+
+    cache.Store(shaders, program_);
 }
 
 auto Shaders::Use() const -> void {
@@ -108,6 +116,10 @@ auto Shaders::SetUniform(std::string_view uniform, const float f) const -> void
     glUniform1f(GetUniform(uniform), f);
 }
 
+auto Shaders::SetUniform(std::string_view uniform, const glm::vec2& vec) const -> void {
+    glUniform2fv(GetUniform(uniform), 1, &vec[0]);
+}
+
 auto Shaders::SetUniform(std::string_view uniform, const glm::vec3& vec) const -> void {
     glUniform3fv(GetUniform(uniform), 1, &vec[0]);
 }
@@ -120,6 +132,16 @@ auto Shaders::SetUniform(std::string_view uniform, const glm::mat4& matrix) cons
     glUniformMatrix4fv(GetUniform(uniform), 1, GL_FALSE, &matrix[0][0]);
 }
 
+auto Shaders::BindUniformBlock(std::string_view block, unsigned binding) const -> void {
+    const auto index = glGetUniformBlockIndex(program_, block.data());
+    if (index == GL_INVALID_INDEX) {
+        throw ShaderError {
+            std::format("Uniform block '{}' not found", block)
+        };
+    }
+    glUniformBlockBinding(program_, index, binding);
+}
+
 Shaders::~Shaders() {
     if (program_) {
         glDeleteProgram(program_);
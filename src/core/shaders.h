@@ -30,10 +30,14 @@ public:
 
     auto SetUniform(std::string_view uniform, int i) const -> void;
     auto SetUniform(std::string_view uniform, const float f) const -> void;
+    auto SetUniform(std::string_view uniform, const glm::vec2& vec) const -> void;
     auto SetUniform(std::string_view uniform, const glm::vec3& vec) const -> void;
     auto SetUniform(std::string_view uniform, const glm::mat3& matrix) const -> void;
     auto SetUniform(std::string_view uniform, const glm::mat4& matrix) const -> void;
 
+    // Points a uniform block at a binding index of glBindBufferRange().
+    auto BindUniformBlock(std::string_view block, unsigned binding) const -> void;
+
     ~Shaders();
 
 private:
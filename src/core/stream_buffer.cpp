@@ -0,0 +1,156 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "stream_buffer.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include <GLFW/glfw3.h>
+
+// glad is generated for GL 4.1, which predates buffer storage.
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+// Regions start on a boundary that satisfies any binding alignment.
+static constexpr std::size_t kRegionAlignment {4096};
+
+using BufferStorageProc = void (APIENTRYP)(GLenum, GLsizeiptr, const void*, GLbitfield);
+
+static auto roundUp(std::size_t size) -> std::size_t {
+    return (size + kRegionAlignment - 1) / kRegionAlignment * kRegionAlignment;
+}
+
+static auto loadBufferStorage() -> BufferStorageProc {
+    auto major = 0;
+    auto minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    auto supported = major > 4 || (major == 4 && minor >= 4);
+    if (!supported) {
+        auto count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (auto i = 0; i < count && !supported; ++i) {
+            const auto name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            supported = std::string_view {name} == "GL_ARB_buffer_storage";
+        }
+    }
+
+    if (!supported) return nullptr;
+    return reinterpret_cast<BufferStorageProc>(glfwGetProcAddress("glBufferStorage"));
+}
+
+StreamBuffer::StreamBuffer(GLenum target, std::size_t frame_bytes) :
+    target_(target),
+    frame_bytes_(roundUp(frame_bytes))
+{
+    Create();
+}
+
+auto StreamBuffer::Create() -> void {
+    glGenBuffers(1, &buffer_);
+    glBindBuffer(target_, buffer_);
+
+    static const auto buffer_storage = loadBufferStorage();
+    if (buffer_storage != nullptr) {
+        const auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        const auto size = static_cast<GLsizeiptr>(frame_bytes_ * kFramesInFlight);
+        buffer_storage(target_, size, nullptr, flags);
+        mapped_ = static_cast<unsigned char*>(glMapBufferRange(target_, 0, size, flags));
+    }
+
+    if (mapped_ == nullptr) {
+        glBufferData(target_, static_cast<GLsizeiptr>(frame_bytes_), nullptr, GL_STREAM_DRAW);
+        staging_ = std::make_unique_for_overwrite<unsigned char[]>(frame_bytes_);
+    }
+
+    glBindBuffer(target_, 0);
+}
+
+auto StreamBuffer::Destroy() -> void {
+    for (auto& fence : fences_) {
+        if (fence == nullptr) continue;
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    if (mapped_ != nullptr) {
+        glBindBuffer(target_, buffer_);
+        glUnmapBuffer(target_);
+        glBindBuffer(target_, 0);
+        mapped_ = nullptr;
+    }
+
+    glDeleteBuffers(1, &buffer_);
+    buffer_ = 0;
+    staging_.reset();
+}
+
+auto StreamBuffer::BeginFrame(std::size_t frame_bytes) -> void {
+    used_ = 0;
+
+    if (frame_bytes > frame_bytes_) {
+        Destroy();
+        frame_bytes_ = roundUp(std::max(frame_bytes, frame_bytes_ * 2));
+        Create();
+    }
+
+    if (mapped_ == nullptr) return;
+
+    frame_ = (frame_ + 1) % kFramesInFlight;
+    region_ = frame_ * frame_bytes_;
+
+    // Only blocks when the CPU is kFramesInFlight frames ahead of the GPU.
+    if (auto& fence = fences_[frame_]; fence != nullptr) {
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+auto StreamBuffer::Allocate(std::size_t bytes, std::size_t alignment) -> Allocation {
+    const auto start = (used_ + alignment - 1) / alignment * alignment;
+    if (start + bytes > frame_bytes_) return {};
+    used_ = start + bytes;
+
+    if (mapped_ != nullptr) {
+        return {.data = mapped_ + region_ + start, .offset = region_ + start};
+    }
+    return {.data = staging_.get() + start, .offset = start};
+}
+
+auto StreamBuffer::Flush() -> void {
+    if (mapped_ != nullptr || used_ == 0) return;
+
+    // Orphaning hands the driver a fresh store, so the upload never waits
+    // for draws still reading last frame's data.
+    glBindBuffer(target_, buffer_);
+    glBufferData(target_, static_cast<GLsizeiptr>(frame_bytes_), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(target_, 0, static_cast<GLsizeiptr>(used_), staging_.get());
+    glBindBuffer(target_, 0);
+}
+
+auto StreamBuffer::EndFrame() -> void {
+    if (mapped_ == nullptr) return;
+    fences_[frame_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+auto StreamBuffer::UniformAlignment() -> std::size_t {
+    static const auto alignment = [] {
+        auto value = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
+        return static_cast<std::size_t>(std::max(value, 16));
+    }();
+    return alignment;
+}
+
+StreamBuffer::~StreamBuffer() {
+    Destroy();
+}
@@ -0,0 +1,93 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+#include <glad/glad.h>
+
+// A ring buffer for data the CPU writes once per frame and the GPU reads in
+// that same frame. The ring holds one region per frame in flight, and a
+// region is reused only after the fence of the frame that last filled it
+// has signalled, so writes are plain stores that never wait on the driver.
+//
+// With glBufferStorage (GL 4.4 or ARB_buffer_storage) the whole ring stays
+// persistently mapped. Otherwise writes are staged in memory and uploaded
+// once per frame into an orphaned buffer.
+class StreamBuffer {
+public:
+    static constexpr std::size_t kFramesInFlight {3};
+
+    struct Allocation {
+        void* data {nullptr};
+
+        // Offset to bind the allocation at.
+        std::size_t offset {0};
+    };
+
+    StreamBuffer(GLenum target, std::size_t frame_bytes);
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Starts writing the next region, waiting for the GPU only if it still
+    // reads it. The ring grows when the frame needs more than a region.
+    auto BeginFrame(std::size_t frame_bytes = 0) -> void;
+
+    // Space in this frame's region. Returns no data once the region is full.
+    [[nodiscard]] auto Allocate(std::size_t bytes, std::size_t alignment) -> Allocation;
+
+    template<typename T>
+    [[nodiscard]] auto Push(const T& value, std::size_t alignment) -> Allocation {
+        const auto allocation = Allocate(sizeof(T), alignment);
+        if (allocation.data != nullptr) std::memcpy(allocation.data, &value, sizeof(T));
+        return allocation;
+    }
+
+    // Makes this frame's writes visible to the GPU. Call after the last
+    // Allocate() and before the draws that read them.
+    auto Flush() -> void;
+
+    // Fences this frame's region. Call after the draws that read it.
+    auto EndFrame() -> void;
+
+    // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, the alignment of uniform block
+    // allocations.
+    [[nodiscard]] static auto UniformAlignment() -> std::size_t;
+
+    [[nodiscard]] auto Id() const -> unsigned int {
+        return buffer_;
+    }
+
+    [[nodiscard]] auto IsPersistent() const -> bool {
+        return mapped_ != nullptr;
+    }
+
+    ~StreamBuffer();
+
+private:
+    GLenum target_ {0};
+
+    unsigned int buffer_ {0};
+
+    std::size_t frame_bytes_ {0};
+
+    // Persistent mode: the mapped ring, and where this frame's region starts.
+    unsigned char* mapped_ {nullptr};
+    std::size_t region_ {0};
+    std::size_t frame_ {0};
+    std::array<GLsync, kFramesInFlight> fences_ {};
+
+    // Fallback mode: this frame's writes, uploaded by Flush().
+    std::unique_ptr<unsigned char[]> staging_;
+
+    std::size_t used_ {0};
+
+    auto Create() -> void;
+
+    auto Destroy() -> void;
+};
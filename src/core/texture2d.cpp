@@ -5,32 +5,129 @@
 
 #include <glad/glad.h>
 
+#include <array>
 #include <iostream>
+#include <utility>
 
-Texture2D::Texture2D(std::shared_ptr<Image> image) {
-    InitTexture(image);
+struct PixelFormat {
+    GLint internal_format;
+    GLenum format;
+    GLenum type;
+
+    // Maps the stored channels to RGBA when sampled, so shaders always see
+    // color: gray as (g, g, g, 1) and gray-alpha as (g, g, g, a).
+    std::array<GLint, 4> swizzle;
+};
+
+static auto pixelFormat(const Image& image) -> PixelFormat {
+    const auto wide = image.bit_depth == 16;
+    const auto type = static_cast<GLenum>(wide ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE);
+    switch (image.depth) {
+        case 1: return {wide ? GL_R16 : GL_R8, GL_RED, type, {GL_RED, GL_RED, GL_RED, GL_ONE}};
+        case 2: return {wide ? GL_RG16 : GL_RG8, GL_RG, type, {GL_RED, GL_RED, GL_RED, GL_GREEN}};
+        case 3: return {wide ? GL_RGB16 : GL_RGB8, GL_RGB, type, {GL_RED, GL_GREEN, GL_BLUE, GL_ONE}};
+        default: return {wide ? GL_RGBA16 : GL_RGBA8, GL_RGBA, type, {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}};
+    }
 }
 
-auto Texture2D::InitTexture(std::shared_ptr<Image> image) -> void {
-    glGenTextures(1, &texture_id_);
-    glBindTexture(GL_TEXTURE_2D, texture_id_);
+// The largest unpack alignment that rows of the image satisfy. Narrow
+// formats have rows that are not a multiple of the default 4 bytes.
+static auto unpackAlignment(const Image& image) -> GLint {
+    const auto row = image.RowBytes();
+    if (row % 8 == 0) return 8;
+    if (row % 4 == 0) return 4;
+    if (row % 2 == 0) return 2;
+    return 1;
+}
+
+static auto generateMipmaps() -> void {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+    glGenerateMipmap(GL_TEXTURE_2D);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+}
+
+Texture2D::Texture2D(std::shared_ptr<Image> image) {
+    InitTexture(image, true);
+}
+
+Texture2D::Texture2D(Texture2D&& other) noexcept :
+    image_(std::move(other.image_)),
+    texture_id_(std::exchange(other.texture_id_, 0)),
+    is_loaded_(std::exchange(other.is_loaded_, false)) {}
+
+Texture2D& Texture2D::operator=(Texture2D&& other) noexcept {
+    if (this != &other) {
+        if (is_loaded_) glDeleteTextures(1, &texture_id_);
+        image_ = std::move(other.image_);
+        texture_id_ = std::exchange(other.texture_id_, 0);
+        is_loaded_ = std::exchange(other.is_loaded_, false);
+    }
+    return *this;
+}
+
+auto Texture2D::CreateTexture(const Image& image, bool generate_mipmaps) -> unsigned int {
+    auto texture_id = 0u;
+    glGenTextures(1, &texture_id);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    const auto pixel = pixelFormat(image);
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, pixel.swizzle.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment(image));
     glTexImage2D(
         GL_TEXTURE_2D,
         0,
-        GL_RGBA,
-        image->width,
-        image->height,
+        pixel.internal_format,
+        image.width,
+        image.height,
         0,
-        GL_RGBA,
-        GL_UNSIGNED_BYTE,
-        image->Data()
+        pixel.format,
+        pixel.type,
+        image.Data()
     );
-    glGenerateMipmap(GL_TEXTURE_2D);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (generate_mipmaps) {
+        generateMipmaps();
+    } else {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    }
+    return texture_id;
+}
+
+auto Texture2D::InitTexture(std::shared_ptr<Image> image, bool generate_mipmaps) -> void {
+    texture_id_ = CreateTexture(*image, generate_mipmaps);
     is_loaded_ = true;
 }
 
+auto Texture2D::Adopt(unsigned int texture_id) -> void {
+    if (texture_id_ != 0) {
+        glDeleteTextures(1, &texture_id_);
+    }
+    texture_id_ = texture_id;
+    image_ = nullptr;
+    is_loaded_ = true;
+}
+
+auto Texture2D::Upload(bool generate_mipmaps) -> std::size_t {
+    if (image_ == nullptr) return 0;
+    const auto bytes = PendingBytes();
+    InitTexture(image_, generate_mipmaps);
+    image_ = nullptr;
+    return bytes;
+}
+
+auto Texture2D::GenerateMipmaps() -> void {
+    if (texture_id_ == 0) return;
+    glBindTexture(GL_TEXTURE_2D, texture_id_);
+    generateMipmaps();
+}
+
+auto Texture2D::PendingBytes() const -> std::size_t {
+    if (image_ == nullptr) return 0;
+    return image_->Bytes();
+}
+
 auto Texture2D::SetImage(std::shared_ptr<Image> image) -> void {
     if (is_loaded_) {
         glDeleteTextures(1, &texture_id_);
@@ -42,8 +139,7 @@ auto Texture2D::SetImage(std::shared_ptr<Image> image) -> void {
 
 auto Texture2D::Bind() -> void {
     if (texture_id_ == 0 && image_ != nullptr) {
-        InitTexture(image_);
-        image_ = nullptr;
+        Upload();
     }
 
     if (texture_id_ == 0) {
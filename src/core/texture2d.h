@@ -5,6 +5,7 @@
 
 #include "core/image.h"
 
+#include <cstddef>
 #include <memory>
 
 class Texture2D {
@@ -13,10 +14,37 @@ public:
 
     explicit Texture2D(std::shared_ptr<Image> image);
 
+    // Owns its GL texture, so it moves rather than copies; TileTextures
+    // keeps textures in a vector that reallocates as tiles arrive.
+    Texture2D(const Texture2D&) = delete;
+    Texture2D& operator=(const Texture2D&) = delete;
+
+    Texture2D(Texture2D&& other) noexcept;
+    Texture2D& operator=(Texture2D&& other) noexcept;
+
     auto SetImage(std::shared_ptr<Image> image) -> void;
 
+    // Uploads the pending image and returns the number of bytes sent. Without
+    // mipmaps the texture samples its base level until GenerateMipmaps().
+    auto Upload(bool generate_mipmaps = true) -> std::size_t;
+
+    auto GenerateMipmaps() -> void;
+
+    // Takes ownership of a texture created elsewhere, typically on a context
+    // that shares objects with this one.
+    auto Adopt(unsigned int texture_id) -> void;
+
+    // Creates and fills a texture on whichever context is current.
+    [[nodiscard]] static auto CreateTexture(const Image& image, bool generate_mipmaps) -> unsigned int;
+
     auto Bind() -> void;
 
+    [[nodiscard]] auto HasPendingUpload() const -> bool {
+        return image_ != nullptr;
+    }
+
+    [[nodiscard]] auto PendingBytes() const -> std::size_t;
+
     [[nodiscard]] auto IsLoaded() const -> bool {
         return is_loaded_;
     }
@@ -26,9 +54,9 @@ public:
 private:
     std::shared_ptr<Image> image_ {nullptr};
 
-    auto InitTexture(std::shared_ptr<Image> image) -> void;
+    auto InitTexture(std::shared_ptr<Image> image, bool generate_mipmaps) -> void;
 
-    unsigned int texture_id_;
+    unsigned int texture_id_ {0};
 
     bool is_loaded_ {false};
 };
\ No newline at end of file
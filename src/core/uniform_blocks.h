@@ -0,0 +1,28 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+// std140 layouts of the uniform blocks the shaders share, and the binding
+// index each one is bound at.
+inline constexpr unsigned kCameraBlockBinding {0};
+inline constexpr unsigned kTileBlockBinding {1};
+
+struct CameraBlock {
+    glm::mat4 projection;
+    glm::mat4 view;
+};
+
+struct TileBlock {
+    glm::mat4 model;
+    glm::vec4 color;
+
+    // Non-zero draws the color instead of sampling the tile's texture.
+    std::int32_t solid;
+    std::int32_t padding[3];
+};
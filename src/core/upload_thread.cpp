@@ -0,0 +1,78 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "upload_thread.h"
+
+#include "core/texture2d.h"
+
+UploadThread::UploadThread(GLFWwindow* context) : context_(context) {
+    thread_ = std::jthread([this] { Run(); });
+}
+
+auto UploadThread::Submit(std::shared_ptr<Image> image, Callback callback) -> bool {
+    if (!jobs_.TryPush(Job {std::move(image), std::move(callback)})) {
+        return false;
+    }
+    ++in_flight_;
+    return true;
+}
+
+auto UploadThread::Run() -> void {
+    glfwMakeContextCurrent(context_);
+
+    while (auto job = jobs_.Pop()) {
+        const auto texture_id = Texture2D::CreateTexture(*job->image, true);
+        job->image = nullptr;
+
+        // The flush makes sure the fence actually reaches the GPU, otherwise
+        // the render thread could wait on a command that was never submitted.
+        const auto fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        auto lock = std::scoped_lock {mutex_};
+        completed_.emplace_back(Completed {texture_id, fence, std::move(job->callback)});
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+auto UploadThread::ProcessCompleted() -> std::size_t {
+    {
+        auto lock = std::scoped_lock {mutex_};
+        for (auto& upload : completed_) {
+            waiting_.emplace_back(std::move(upload));
+        }
+        completed_.clear();
+    }
+
+    // Polls each fence without blocking; unsignalled uploads wait for a
+    // later frame in submission order.
+    auto processed = std::size_t {0};
+    while (processed < waiting_.size()) {
+        auto& upload = waiting_[processed];
+        const auto status = glClientWaitSync(upload.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+        glDeleteSync(upload.fence);
+        upload.callback(upload.texture_id);
+        ++processed;
+    }
+
+    waiting_.erase(waiting_.begin(), waiting_.begin() + static_cast<std::ptrdiff_t>(processed));
+    in_flight_ -= processed;
+    return processed;
+}
+
+UploadThread::~UploadThread() {
+    jobs_.Close();
+    thread_.join();
+
+    // Uploads nobody collected are released on the render context.
+    auto discard = [](Completed& upload) {
+        glDeleteSync(upload.fence);
+        glDeleteTextures(1, &upload.texture_id);
+    };
+    for (auto& upload : completed_) discard(upload);
+    for (auto& upload : waiting_) discard(upload);
+
+    glfwDestroyWindow(context_);
+}
@@ -0,0 +1,74 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "core/bounded_queue.h"
+#include "core/image.h"
+
+// Creates and fills textures on a second context that shares objects with
+// the render context. Each finished texture is fenced, and the render thread
+// adopts it once the fence has signalled, so uploads never stall a frame.
+class UploadThread {
+public:
+    using Callback = std::function<void(unsigned int texture_id)>;
+
+    static constexpr std::size_t kQueueCapacity {32};
+
+    // Takes ownership of a hidden window whose context shares with the
+    // render context (see Window::CreateSharedContext).
+    explicit UploadThread(GLFWwindow* context);
+
+    UploadThread(const UploadThread&) = delete;
+    UploadThread& operator=(const UploadThread&) = delete;
+
+    // Never blocks. Returns false when the upload queue is full.
+    auto Submit(std::shared_ptr<Image> image, Callback callback) -> bool;
+
+    // Invokes callbacks for uploads whose fence has signalled. Must be
+    // called on the render thread.
+    auto ProcessCompleted() -> std::size_t;
+
+    [[nodiscard]] auto InFlight() const -> std::size_t {
+        return in_flight_;
+    }
+
+    ~UploadThread();
+
+private:
+    struct Job {
+        std::shared_ptr<Image> image;
+        Callback callback;
+    };
+
+    struct Completed {
+        unsigned int texture_id {0};
+        GLsync fence {nullptr};
+        Callback callback;
+    };
+
+    GLFWwindow* context_ {nullptr};
+
+    BoundedQueue<Job> jobs_ {kQueueCapacity};
+
+    std::mutex mutex_;
+    std::vector<Completed> completed_;
+    std::vector<Completed> waiting_;
+
+    std::atomic<std::size_t> in_flight_ {0};
+
+    std::jthread thread_;
+
+    auto Run() -> void;
+};
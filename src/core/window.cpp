@@ -14,6 +14,21 @@
 #include "events.h"
 #include "event_dispatcher.h"
 
+// Cursor and scroll input is folded into a single event per frame, so
+// listeners see one delta instead of every intermediate sample.
+struct PendingInput {
+    glm::vec2 position {0.0f};
+    glm::vec2 scroll {0.0f};
+
+    bool moved {false};
+    bool scrolled {false};
+};
+
+static auto pending_input = PendingInput {};
+
+static auto flushPendingInput() -> void;
+static auto requestRedraw(GLFWwindow* window) -> void;
+
 static auto glfwMouseButtonMap(int button) -> MouseButton;
 static auto glfwCursorPosCallback(GLFWwindow*, double x, double y) -> void;
 static auto glfwMouseButtonCallback(GLFWwindow*, int button, int action, int mods) -> void;
@@ -30,7 +45,7 @@ constexpr auto callback_error =
     std::cout << std::format("Error ({}): {}\n", error, message);
 };
 
-Window::Window(int width, int height, std::string_view title) {
+Window::Window(int width, int height, std::string_view title, bool visible) {
     glfwSetErrorCallback(callback_error);
 
     if (!glfwInit()) {
@@ -46,6 +61,7 @@ Window::Window(int width, int height, std::string_view title) {
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
 
     #ifdef __APPLE__
         glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GLFW_TRUE);
@@ -88,8 +104,50 @@ auto Window::Start(const std::function<void(const double delta)> &program) -> vo
 
         imguiAfterRender();
         glfwSwapBuffers(window_);
+        ProcessEvents();
+    }
+}
+
+auto Window::SetRenderMode(RenderMode mode) -> void {
+    render_mode_ = mode;
+    redraw_frames_ = kRedrawFrames;
+
+    // An on-demand loop only renders while something changes, so there is
+    // no reason to outrun the display when it does.
+    glfwSwapInterval(mode == RenderMode::OnDemand ? 1 : 0);
+}
+
+auto Window::RequestRedraw() -> void {
+    redraw_frames_ = kRedrawFrames;
+}
+
+auto Window::FramebufferScale() const -> float {
+    auto window_width {0}, window_height {0};
+    auto buffer_width {0}, buffer_height {0};
+    glfwGetWindowSize(window_, &window_width, &window_height);
+    glfwGetFramebufferSize(window_, &buffer_width, &buffer_height);
+    return window_width > 0 ? static_cast<float>(buffer_width) / window_width : 1.0f;
+}
+
+auto Window::CreateSharedContext() const -> GLFWwindow* {
+    // The context hints from construction still apply, so the shared
+    // context gets the same version and profile.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    auto context = glfwCreateWindow(1, 1, "", nullptr, window_);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    return context;
+}
+
+auto Window::ProcessEvents() -> void {
+    if (redraw_frames_ > 0) --redraw_frames_;
+
+    if (render_mode_ == RenderMode::OnDemand && redraw_frames_ == 0) {
+        glfwWaitEventsTimeout(kIdleTimeout);
+    } else {
         glfwPollEvents();
     }
+
+    flushPendingInput();
 }
 
 Window::~Window() {
@@ -98,18 +156,51 @@ Window::~Window() {
     glfwTerminate();
 }
 
-static auto glfwCursorPosCallback(GLFWwindow* _, double x, double y) -> void {
-    auto event = std::make_unique<MouseEvent>();
-    event->type = MouseEvent::Type::Moved;
-    event->button = MouseButton::None;
-    event->position = {static_cast<float>(x), static_cast<float>(y)};
-    event->scroll = {0.0f, 0.0f};
+static auto flushPendingInput() -> void {
+    if (pending_input.moved) {
+        auto event = std::make_unique<MouseEvent>();
+        event->type = MouseEvent::Type::Moved;
+        event->button = MouseButton::None;
+        event->position = pending_input.position;
+        event->scroll = {0.0f, 0.0f};
+
+        EventDispatcher::Get().Dispatch("mouse_event", std::move(event));
+    }
+
+    if (pending_input.scrolled) {
+        auto event = std::make_unique<MouseEvent>();
+        event->type = MouseEvent::Type::Scrolled;
+        event->button = MouseButton::None;
+        event->position = pending_input.position;
+        event->scroll = pending_input.scroll;
+
+        EventDispatcher::Get().Dispatch("mouse_event", std::move(event));
+    }
 
-    EventDispatcher::Get().Dispatch("mouse_event", std::move(event));
+    pending_input.scroll = {0.0f, 0.0f};
+    pending_input.moved = false;
+    pending_input.scrolled = false;
+}
+
+static auto requestRedraw(GLFWwindow* window) -> void {
+    if (auto instance = static_cast<Window*>(glfwGetWindowUserPointer(window))) {
+        instance->RequestRedraw();
+    }
+}
+
+static auto glfwCursorPosCallback(GLFWwindow* window, double x, double y) -> void {
+    requestRedraw(window);
+    pending_input.position = {static_cast<float>(x), static_cast<float>(y)};
+    pending_input.moved = true;
 }
 
 static auto glfwMouseButtonCallback(GLFWwindow* window, int button, int action, int) -> void {
+    requestRedraw(window);
     if (imguiEvent()) return;
+
+    // Button transitions must be observed after the motion that preceded them.
+    flushPendingInput();
+
     auto event = std::make_unique<MouseEvent>();
 
     event->type = MouseEvent::Type::ButtonPressed;
@@ -127,14 +218,11 @@ static auto glfwMouseButtonCallback(GLFWwindow* window, int button, int action,
 }
 
 static auto glfwScrollCallback(GLFWwindow* window, double x, double y) -> void {
+    requestRedraw(window);
     if (imguiEvent()) return;
-    auto event = std::make_unique<MouseEvent>();
-
-    event->type = MouseEvent::Type::Scrolled;
-    event->button = MouseButton::None;
-    event->scroll = {static_cast<float>(x), static_cast<float>(y)};
 
-    EventDispatcher::Get().Dispatch("mouse_event", std::move(event));
+    pending_input.scroll += glm::vec2 {static_cast<float>(x), static_cast<float>(y)};
+    pending_input.scrolled = true;
 }
 
 static auto glfwMouseButtonMap(int button) -> MouseButton {
@@ -174,4 +262,4 @@ static auto imguiCleanup() -> void {
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
-}
\ No newline at end of file
+}
\ No newline at end of file
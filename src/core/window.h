@@ -11,15 +11,45 @@
 
 #include "core/timer.h"
 
+enum class RenderMode {
+    Continuous,
+    OnDemand
+};
+
 class Window {
 public:
-    Window(int width, int height, std::string_view title);
+    // Frames rendered after the last redraw request, so that ImGui gets a
+    // frame to settle hover and focus state before the loop goes idle.
+    static constexpr int kRedrawFrames {2};
+
+    // Upper bound on how long an idle on-demand loop blocks for events.
+    static constexpr double kIdleTimeout {0.5};
+
+    // A hidden window only provides a context, for offscreen work.
+    Window(int width, int height, std::string_view title, bool visible = true);
 
     auto Start(const std::function<void(const double delta)>& program) -> void;
 
+    auto SetRenderMode(RenderMode mode) -> void;
+
+    auto RequestRedraw() -> void;
+
+    // Framebuffer pixels per window coordinate, 2 on Retina displays.
+    [[nodiscard]] auto FramebufferScale() const -> float;
+
+    // Creates a hidden window whose context shares objects with this one,
+    // for use on another thread. Returns nullptr if it cannot be created.
+    [[nodiscard]] auto CreateSharedContext() const -> GLFWwindow*;
+
     ~Window();
 
 private:
     GLFWwindow* window_ {nullptr};
     Timer timer_ {};
-};
\ No newline at end of file
+
+    RenderMode render_mode_ {RenderMode::Continuous};
+
+    int redraw_frames_ {kRedrawFrames};
+
+    auto ProcessEvents() -> void;
+};
\ No newline at end of file
@@ -0,0 +1,176 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "layer_stack.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <utility>
+
+#include <imgui.h>
+
+static constexpr std::array kBlendModes {"Normal", "Additive", "Multiply"};
+
+LayerStack::Layer::Layer(
+    std::string name,
+    const LayerStyle& style,
+    const Config& config,
+    std::shared_ptr<TileSource> source,
+    std::shared_ptr<LoadPipeline<Image>> pipeline
+) :
+    name(std::move(name)),
+    style(style),
+    tiles(
+        config.image_dims,
+        config.window_dims,
+        config.tile_size,
+        config.lods,
+        std::move(source),
+        std::move(pipeline),
+        config.loader
+    ),
+    textures(&tiles) {}
+
+LayerStack::LayerStack(const Config& config) :
+    config_(config),
+    pipeline_(std::make_shared<LoadPipeline<Image>>(config.loader, config.pipeline)) {}
+
+auto LayerStack::Add(
+    std::string name,
+    std::shared_ptr<TileSource> source,
+    const LayerStyle& style
+) -> Layer& {
+    layers_.emplace_back(std::make_unique<Layer>(
+        std::move(name),
+        style,
+        config_,
+        std::move(source),
+        pipeline_
+    ));
+    return *layers_.back();
+}
+
+auto LayerStack::SetZoomVelocity(float lods_per_second) -> void {
+    for (auto& layer : layers_) layer->tiles.SetZoomVelocity(lods_per_second);
+}
+
+auto LayerStack::Update(const OrthographicCamera& camera, const UploadBudget& budget) -> void {
+    // Results of hidden layers still have to be collected.
+    pipeline_->ProcessReady();
+
+    const auto order = ScheduleOrder();
+
+    // Each layer may take an equal share of what is still free among the
+    // layers of its priority. Shares a layer leaves unused stay free for
+    // the ones after it, and lower priorities get whatever remains.
+    for (auto i = std::size_t {0}; i < order.size(); ++i) {
+        auto left_in_group = std::size_t {0};
+        for (auto j = i; j < order.size() && order[j]->priority == order[i]->priority; ++j) {
+            ++left_in_group;
+        }
+        const auto available = pipeline_->Available();
+        order[i]->tiles.SetRequestQuota((available + left_in_group - 1) / left_in_group);
+        order[i]->tiles.Update(camera);
+    }
+
+    if (!order.empty()) {
+        const auto shown = static_cast<int>(order.size());
+        const auto share = UploadBudget {
+            .uploads = std::max(budget.uploads / shown, 1),
+            .bytes = budget.bytes / order.size(),
+            .mipmaps = budget.mipmaps > 0 ? std::max(budget.mipmaps / shown, 1) : 0
+        };
+        for (auto* layer : order) layer->textures.Update(share);
+    }
+
+    ++turn_;
+    EnforceBudget();
+}
+
+auto LayerStack::ScheduleOrder() const -> std::vector<Layer*> {
+    auto order = std::vector<Layer*> {};
+    for (const auto& layer : layers_) {
+        if (layer->IsShown()) order.emplace_back(layer.get());
+    }
+    if (order.empty()) return order;
+
+    // Rotating before a stable sort by priority rotates every group.
+    std::ranges::rotate(order, order.begin() + static_cast<std::ptrdiff_t>(turn_ % order.size()));
+    std::ranges::stable_sort(order, std::greater {}, &Layer::priority);
+    return order;
+}
+
+auto LayerStack::EnforceBudget() -> void {
+    auto resident = ResidentBytes();
+    if (resident <= config_.texture_budget) return;
+
+    // Hidden layers give up their textures first, then the shown ones from
+    // the lowest priority up.
+    auto victims = std::vector<Layer*> {};
+    for (const auto& layer : layers_) victims.emplace_back(layer.get());
+    std::ranges::stable_sort(victims, [](const Layer* a, const Layer* b) {
+        if (a->IsShown() != b->IsShown()) return !a->IsShown();
+        return a->priority < b->priority;
+    });
+
+    for (auto* layer : victims) {
+        resident -= layer->textures.Evict(resident - config_.texture_budget);
+        if (resident <= config_.texture_budget) break;
+    }
+}
+
+auto LayerStack::Draw(const OrthographicCamera& camera, TileRenderer& renderer) -> void {
+    renderer.BeginFrame();
+    for (const auto& layer : layers_) {
+        if (!layer->IsShown()) continue;
+        renderer.Draw(camera, layer->tiles.GetRenderList(), layer->textures, layer->style);
+    }
+    renderer.EndFrame();
+}
+
+auto LayerStack::HasPendingWork() const -> bool {
+    return std::ranges::any_of(layers_, [](const auto& layer) {
+        return layer->IsShown() && (layer->tiles.HasPendingWork() || layer->textures.HasPendingWork());
+    });
+}
+
+auto LayerStack::ResidentBytes() const -> std::size_t {
+    auto bytes = std::size_t {0};
+    for (const auto& layer : layers_) bytes += layer->textures.ResidentBytes();
+    return bytes;
+}
+
+auto LayerStack::Debug() -> void {
+    const auto stats = pipeline_->GetStats();
+
+    ImGui::Begin("Layers");
+    ImGui::Text(
+        "Textures: %.1f / %.1f MB",
+        ResidentBytes() / (1024.0 * 1024.0),
+        config_.texture_budget / (1024.0 * 1024.0)
+    );
+    ImGui::Text(
+        "Load queues: %zu I/O, %zu decode, %zu ready",
+        stats.io_queued,
+        stats.decode_queued,
+        stats.ready_queued
+    );
+
+    for (auto i = std::size_t {0}; i < layers_.size(); ++i) {
+        auto& layer = *layers_[i];
+        auto blend = static_cast<int>(layer.style.blend);
+
+        ImGui::Separator();
+        ImGui::PushID(static_cast<int>(i));
+        ImGui::Checkbox(layer.name.c_str(), &layer.visible);
+        ImGui::SliderFloat("Opacity", &layer.style.opacity, 0.0f, 1.0f);
+        if (ImGui::Combo("Blend", &blend, kBlendModes.data(), static_cast<int>(kBlendModes.size()))) {
+            layer.style.blend = static_cast<BlendMode>(blend);
+        }
+        ImGui::InputInt("Priority", &layer.priority);
+        ImGui::Text("Textures: %.1f MB", layer.textures.ResidentBytes() / (1024.0 * 1024.0));
+        ImGui::PopID();
+    }
+    ImGui::End();
+}
@@ -0,0 +1,114 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/frame_governor.h"
+#include "core/orthographic_camera.h"
+#include "loaders/image_loader.h"
+#include "loaders/load_pipeline.h"
+#include "sources/tile_source.h"
+#include "tile_manager.h"
+#include "tile_renderer.h"
+#include "tile_textures.h"
+#include "types.h"
+
+// Co-registered pyramids drawn over each other, such as channels, masks or
+// heatmaps. Every layer streams through one load pipeline and all of them
+// share one texture budget, so adding a layer adds neither threads nor
+// unbounded VRAM.
+//
+// Each frame the pipeline's free capacity is split between the layers on
+// screen. Higher priority layers are served first, and layers of equal
+// priority take turns at going first so that none of them starves.
+class LayerStack {
+public:
+    struct Config {
+        Dimensions image_dims;
+        Dimensions window_dims;
+        float tile_size {0.0f};
+        int lods {0};
+
+        // Base-level texture bytes for all layers together.
+        std::size_t texture_budget {512 * 1024 * 1024};
+
+        // The one pipeline every layer streams through. Its readers must
+        // read whatever paths the layers' sources locate; by default they
+        // read local files.
+        LoadPipeline<Image>::Config pipeline {};
+        std::shared_ptr<Loader<Image>> loader {ImageLoader::Create()};
+    };
+
+    struct Layer {
+        std::string name;
+        LayerStyle style;
+        bool visible {true};
+
+        // Layers with a higher priority request their tiles first.
+        int priority {0};
+
+        TileManager tiles;
+        TileTextures textures;
+
+        Layer(
+            std::string name,
+            const LayerStyle& style,
+            const Config& config,
+            std::shared_ptr<TileSource> source,
+            std::shared_ptr<LoadPipeline<Image>> pipeline
+        );
+
+        [[nodiscard]] auto IsShown() const -> bool {
+            return visible && style.opacity > 0.0f;
+        }
+    };
+
+    explicit LayerStack(const Config& config);
+
+    LayerStack(const LayerStack&) = delete;
+    LayerStack& operator=(const LayerStack&) = delete;
+
+    // Layers draw in the order they are added.
+    auto Add(
+        std::string name,
+        std::shared_ptr<TileSource> source,
+        const LayerStyle& style = {}
+    ) -> Layer&;
+
+    // Streams and uploads tiles for the layers on screen, splitting the
+    // pipeline and the upload budget between them, then evicts textures
+    // while the stack is over its budget.
+    auto Update(const OrthographicCamera& camera, const UploadBudget& budget) -> void;
+
+    // Passed on to every layer's TileManager::SetZoomVelocity().
+    auto SetZoomVelocity(float lods_per_second) -> void;
+
+    auto Draw(const OrthographicCamera& camera, TileRenderer& renderer) -> void;
+
+    [[nodiscard]] auto HasPendingWork() const -> bool;
+
+    [[nodiscard]] auto ResidentBytes() const -> std::size_t;
+
+    auto Debug() -> void;
+
+private:
+    Config config_;
+
+    // Declared before the layers so that it outlives their callbacks.
+    std::shared_ptr<LoadPipeline<Image>> pipeline_;
+
+    std::vector<std::unique_ptr<Layer>> layers_;
+
+    // Rotates which of several equal-priority layers requests first.
+    std::size_t turn_ {0};
+
+    // Shown layers in the order they request tiles this frame.
+    auto ScheduleOrder() const -> std::vector<Layer*>;
+
+    auto EnforceBudget() -> void;
+};
@@ -0,0 +1,55 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "file_reader.h"
+
+#include <format>
+#include <fstream>
+
+#include "core/buffer_pool.h"
+
+#ifdef TILE_STREAMING_HAS_IO_URING
+#include "loaders/uring_file_reader.h"
+#endif
+
+auto FileReader::Create([[maybe_unused]] bool prefer_io_uring) -> std::unique_ptr<FileReader> {
+#ifdef TILE_STREAMING_HAS_IO_URING
+    if (prefer_io_uring) {
+        if (auto reader = UringFileReader::Create()) return reader;
+    }
+#endif
+    return std::make_unique<BlockingFileReader>();
+}
+
+auto BlockingFileReader::Read(const fs::path& path) -> ReadResult {
+    auto error = std::error_code {};
+    const auto size = fs::file_size(path, error);
+    if (error) {
+        return std::unexpected(std::format("{} '{}'", kFileNotFound, path.string()));
+    }
+
+    auto data = FileData {
+        .bytes = FileBuffer {
+            static_cast<unsigned char*>(BufferPool::Get().Allocate(size)),
+            [](void* ptr) { BufferPool::Get().Free(ptr); }
+        },
+        .size = size
+    };
+
+    auto file = std::ifstream {path, std::ios::binary};
+    file.read(reinterpret_cast<char*>(data.bytes.get()), static_cast<std::streamsize>(size));
+    if (!file) {
+        return std::unexpected(std::format("Failed to read file '{}'", path.string()));
+    }
+
+    return data;
+}
+
+auto BlockingFileReader::ReadBatch(std::span<const fs::path> paths) -> std::vector<ReadResult> {
+    auto results = std::vector<ReadResult> {};
+    results.reserve(paths.size());
+    for (const auto& path : paths) {
+        results.emplace_back(Read(path));
+    }
+    return results;
+}
@@ -0,0 +1,64 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using FileBuffer = std::unique_ptr<unsigned char[], std::function<void(void*)>>;
+
+struct FileData {
+    FileBuffer bytes {nullptr, [](void*){}};
+    std::size_t size {0};
+
+    [[nodiscard]] auto Bytes() const {
+        return std::span<const unsigned char> {bytes.get(), size};
+    }
+};
+
+using ReadResult = std::expected<FileData, std::string>;
+
+// Readers report a file that does not exist with an error that starts with
+// this, so callers can tell an absent tile from one that failed to read.
+inline constexpr auto kFileNotFound = std::string_view {"File not found"};
+
+[[nodiscard]] inline auto IsNotFound(std::string_view error) -> bool {
+    return error.starts_with(kFileNotFound);
+}
+
+class FileReader {
+public:
+    // Returns an io_uring reader when it is compiled in and the kernel
+    // supports it, and a blocking reader otherwise.
+    [[nodiscard]] static auto Create(bool prefer_io_uring = true) -> std::unique_ptr<FileReader>;
+
+    // Reads every path in one go. Results are returned in request order.
+    [[nodiscard]] virtual auto ReadBatch(std::span<const fs::path> paths) -> std::vector<ReadResult> = 0;
+
+    // Largest batch worth handing to ReadBatch() at once. Readers without
+    // batching return 1 so that requests spread across I/O workers instead.
+    [[nodiscard]] virtual auto MaxBatchSize() const -> std::size_t = 0;
+
+    virtual ~FileReader() = default;
+};
+
+class BlockingFileReader : public FileReader {
+public:
+    [[nodiscard]] static auto Read(const fs::path& path) -> ReadResult;
+
+    [[nodiscard]] auto ReadBatch(std::span<const fs::path> paths) -> std::vector<ReadResult> override;
+
+    [[nodiscard]] auto MaxBatchSize() const -> std::size_t override {
+        return 1;
+    }
+};
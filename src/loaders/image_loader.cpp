@@ -3,21 +3,41 @@
 
 #define STB_IMAGE_IMPLEMENTATION
 
+// Route every stb allocation through the pool so that decode scratch and the
+// returned pixels reuse tile-sized slabs instead of hitting the heap.
+#define STBI_MALLOC(size) BufferPool::Get().Allocate(size)
+#define STBI_REALLOC(ptr, size) BufferPool::Get().Reallocate(ptr, size)
+#define STBI_FREE(ptr) BufferPool::Get().Free(ptr)
+
 #include "image_loader.h"
 
+#include <array>
 #include <iostream>
 
+#include "core/buffer_pool.h"
+
 #include <stb_image.h>
 
-auto ImageLoader::ValidFileExtensions() const -> std::vector<std::string> {
-    return {".png", ".jpg", ".jpeg"};
+auto ImageLoader::ValidFileExtensions() const -> std::span<const std::string_view> {
+    static constexpr std::array<std::string_view, 3> kExtensions {".png", ".jpg", ".jpeg"};
+    return kExtensions;
 }
 
-auto ImageLoader::LoadImpl(const fs::path& path) const -> std::shared_ptr<void> {
+auto ImageLoader::DecodeImpl(
+    std::span<const unsigned char> bytes,
+    const fs::path& path
+) const -> std::shared_ptr<void> {
     auto width = 0;
     auto height = 0;
     auto depth = 0;
-    auto data = stbi_load(path.string().c_str(), &width, &height, &depth, 4);
+
+    // Tiles keep their native channel count and bit depth; Texture2D picks
+    // the matching texture format, so gray tiles cost a quarter of RGBA.
+    const auto size = static_cast<int>(bytes.size());
+    const auto is_16_bit = stbi_is_16_bit_from_memory(bytes.data(), size) != 0;
+    auto data = is_16_bit
+        ? static_cast<void*>(stbi_load_16_from_memory(bytes.data(), size, &width, &height, &depth, 0))
+        : static_cast<void*>(stbi_load_from_memory(bytes.data(), size, &width, &height, &depth, 0));
 
     if (data == nullptr) {
         std::cerr << "Failed to load image '" << path.string() << "'\n";
@@ -28,6 +48,7 @@ auto ImageLoader::LoadImpl(const fs::path& path) const -> std::shared_ptr<void>
         .filename = path.filename().string(),
         .width = width,
         .height = height,
-        .depth = depth
-    }, ImageData(data, &stbi_image_free)});
+        .depth = depth,
+        .bit_depth = is_16_bit ? 16 : 8
+    }, ImageData(static_cast<unsigned char*>(data), &stbi_image_free)});
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace fs = std::filesystem;
@@ -25,7 +26,10 @@ public:
 private:
     ImageLoader() = default;
 
-    [[nodiscard]] auto ValidFileExtensions() const -> std::vector<std::string> override;
+    [[nodiscard]] auto ValidFileExtensions() const -> std::span<const std::string_view> override;
 
-    [[nodiscard]] auto LoadImpl(const fs::path& path) const -> std::shared_ptr<void> override;
+    [[nodiscard]] auto DecodeImpl(
+        std::span<const unsigned char> bytes,
+        const fs::path& path
+    ) const -> std::shared_ptr<void> override;
 };
\ No newline at end of file
@@ -0,0 +1,246 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/bounded_queue.h"
+#include "loaders/file_reader.h"
+#include "loaders/loader.h"
+
+namespace fs = std::filesystem;
+
+// Runs a loader as three stages: I/O workers read raw bytes, decode workers
+// turn them into resources, and finished results wait in a ready queue until
+// the owning thread collects them with ProcessReady(). Every stage has its
+// own bounded queue, so a slow disk and a burst of decodes cannot starve
+// each other, and a full stage pushes back on the one before it.
+//
+// Requests are staged by LoadAsync() and handed to the I/O stage by Flush(),
+// so everything requested in one frame reaches the file reader as a batch.
+template <typename Resource>
+class LoadPipeline {
+public:
+    struct Config {
+        unsigned io_workers {2};
+        unsigned decode_workers {std::max(1u, std::thread::hardware_concurrency() / 2)};
+
+        std::size_t io_queue_capacity {64};
+        std::size_t decode_queue_capacity {16};
+        std::size_t ready_queue_capacity {32};
+
+        bool use_io_uring {true};
+
+        // Creates the reader for each I/O worker. Defaults to local files.
+        std::function<std::unique_ptr<FileReader>()> make_reader {};
+
+        // An optional cache of decoded resources. The I/O stage looks every
+        // path up before reading it, and a hit skips both the read and the
+        // decode. Decode workers store what they decode. Both are called
+        // from worker threads.
+        std::function<std::shared_ptr<Resource>(const fs::path&)> lookup {};
+        std::function<void(const fs::path&, const std::shared_ptr<Resource>&)> store {};
+    };
+
+    struct Stats {
+        std::size_t io_queued {0};
+        std::size_t decode_queued {0};
+        std::size_t ready_queued {0};
+    };
+
+    explicit LoadPipeline(std::shared_ptr<Loader<Resource>> loader) :
+        LoadPipeline(std::move(loader), Config {}) {}
+
+    LoadPipeline(std::shared_ptr<Loader<Resource>> loader, const Config& config) :
+        LoadPipeline(std::move(loader), config, CreateReaders(config)) {}
+
+    LoadPipeline(const LoadPipeline&) = delete;
+    LoadPipeline& operator=(const LoadPipeline&) = delete;
+
+    // Never blocks the caller. Returns false when the I/O stage is saturated,
+    // in which case the callback is not retained and the request can be retried.
+    auto LoadAsync(const fs::path& path, LoaderCallback<Resource> callback) -> bool {
+        if (io_pending_.load() + staged_.size() >= io_capacity_) return false;
+        staged_.emplace_back(IoJob {path, std::move(callback)});
+        return true;
+    }
+
+    // How many more requests LoadAsync() would accept right now.
+    [[nodiscard]] auto Available() const -> std::size_t {
+        const auto used = io_pending_.load() + staged_.size();
+        return used < io_capacity_ ? io_capacity_ - used : 0;
+    }
+
+    // Hands staged requests to the I/O stage in batches the reader can take at once.
+    auto Flush() -> void {
+        for (auto first = std::size_t {0}; first < staged_.size(); first += batch_size_) {
+            const auto last = std::min(staged_.size(), first + batch_size_);
+            auto batch = std::vector<IoJob> {};
+            batch.reserve(last - first);
+            for (auto i = first; i < last; ++i) {
+                batch.emplace_back(std::move(staged_[i]));
+            }
+            io_pending_ += batch.size();
+            io_queue_.Push(std::move(batch));
+        }
+        staged_.clear();
+    }
+
+    // Invokes callbacks for finished loads on the calling thread.
+    auto ProcessReady(
+        std::size_t max_results = std::numeric_limits<std::size_t>::max()
+    ) -> std::size_t {
+        auto processed = std::size_t {0};
+        while (processed < max_results) {
+            auto job = ready_queue_.TryPop();
+            if (!job) break;
+            job->callback(std::move(job->result));
+            ++processed;
+        }
+        return processed;
+    }
+
+    // The configured cache, for loads made outside the pipeline.
+    [[nodiscard]] auto FindCached(const fs::path& path) const -> std::shared_ptr<Resource> {
+        return lookup_ ? lookup_(path) : nullptr;
+    }
+
+    auto StoreDecoded(const fs::path& path, const std::shared_ptr<Resource>& resource) const -> void {
+        if (store_) store_(path, resource);
+    }
+
+    [[nodiscard]] auto GetStats() const -> Stats {
+        return {
+            .io_queued = io_pending_.load(),
+            .decode_queued = decode_queue_.Size(),
+            .ready_queued = ready_queue_.Size()
+        };
+    }
+
+    ~LoadPipeline() {
+        io_queue_.Close();
+        decode_queue_.Close();
+        ready_queue_.Close();
+        workers_.clear();
+    }
+
+private:
+    struct IoJob {
+        fs::path path;
+        LoaderCallback<Resource> callback;
+    };
+
+    struct DecodeJob {
+        fs::path path;
+        FileData data;
+        LoaderCallback<Resource> callback;
+    };
+
+    struct ReadyJob {
+        LoaderResult<Resource> result;
+        LoaderCallback<Resource> callback;
+    };
+
+    std::shared_ptr<Loader<Resource>> loader_;
+
+    std::function<std::shared_ptr<Resource>(const fs::path&)> lookup_;
+    std::function<void(const fs::path&, const std::shared_ptr<Resource>&)> store_;
+
+    std::vector<IoJob> staged_;
+    std::atomic<std::size_t> io_pending_ {0};
+    std::size_t io_capacity_ {0};
+
+    // Batches handed to the I/O stage are sized for the reader that takes
+    // the fewest paths at once, since any worker may pick up any batch.
+    const std::size_t batch_size_ {1};
+
+    BoundedQueue<std::vector<IoJob>> io_queue_;
+    BoundedQueue<DecodeJob> decode_queue_;
+    BoundedQueue<ReadyJob> ready_queue_;
+
+    std::vector<std::jthread> workers_;
+
+    // Each I/O worker owns its reader, so rings are never shared.
+    LoadPipeline(
+        std::shared_ptr<Loader<Resource>> loader,
+        const Config& config,
+        std::vector<std::shared_ptr<FileReader>> readers
+    ) :
+        loader_(std::move(loader)),
+        lookup_(config.lookup),
+        store_(config.store),
+        io_capacity_(config.io_queue_capacity),
+        batch_size_(std::ranges::min(readers, {}, [](const auto& reader) { return reader->MaxBatchSize(); })->MaxBatchSize()),
+        io_queue_(config.io_queue_capacity),
+        decode_queue_(config.decode_queue_capacity),
+        ready_queue_(config.ready_queue_capacity)
+    {
+        for (auto& reader : readers) {
+            workers_.emplace_back([this, reader] { RunIoStage(*reader); });
+        }
+        for (auto i = 0u; i < config.decode_workers; ++i) {
+            workers_.emplace_back([this] { RunDecodeStage(); });
+        }
+    }
+
+    static auto CreateReaders(const Config& config) -> std::vector<std::shared_ptr<FileReader>> {
+        auto readers = std::vector<std::shared_ptr<FileReader>> {};
+        for (auto i = 0u; i < std::max(1u, config.io_workers); ++i) {
+            readers.emplace_back(config.make_reader ? config.make_reader() : FileReader::Create(config.use_io_uring));
+        }
+        return readers;
+    }
+
+    auto RunIoStage(FileReader& reader) -> void {
+        while (auto batch = io_queue_.Pop()) {
+            auto jobs = std::vector<IoJob> {};
+            auto paths = std::vector<fs::path> {};
+            for (auto& job : *batch) {
+                if (auto valid = loader_->Validate(job.path); !valid) {
+                    if (!ready_queue_.Push({std::unexpected(valid.error()), std::move(job.callback)})) return;
+                    continue;
+                }
+                if (auto cached = FindCached(job.path)) {
+                    if (!ready_queue_.Push({std::move(cached), std::move(job.callback)})) return;
+                    continue;
+                }
+                paths.emplace_back(job.path);
+                jobs.emplace_back(std::move(job));
+            }
+
+            auto results = reader.ReadBatch(paths);
+            io_pending_ -= batch->size();
+
+            for (auto i = std::size_t {0}; i < jobs.size(); ++i) {
+                if (!results[i]) {
+                    if (!ready_queue_.Push({std::unexpected(results[i].error()), std::move(jobs[i].callback)})) return;
+                    continue;
+                }
+                auto decode_job = DecodeJob {
+                    std::move(jobs[i].path),
+                    std::move(results[i].value()),
+                    std::move(jobs[i].callback)
+                };
+                if (!decode_queue_.Push(std::move(decode_job))) return;
+            }
+        }
+    }
+
+    auto RunDecodeStage() -> void {
+        while (auto job = decode_queue_.Pop()) {
+            auto result = loader_->Decode(job->data, job->path);
+            job->data = {};
+            if (result) StoreDecoded(job->path, result.value());
+            if (!ready_queue_.Push({std::move(result), std::move(job->callback)})) return;
+        }
+    }
+};
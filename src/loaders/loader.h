@@ -10,9 +10,12 @@
 #include <functional>
 #include <iostream>
 #include <memory>
-#include <thread>
+#include <span>
+#include <string_view>
 #include <vector>
 
+#include "loaders/file_reader.h"
+
 namespace fs = std::filesystem;
 
 template <typename T>
@@ -25,64 +28,59 @@ template <typename Resource>
 class Loader : public std::enable_shared_from_this<Loader<Resource>> {
 public:
     auto Load(const fs::path& path, LoaderCallback<Resource> callback) const {
-        if (!ValidateFile(path, callback)) return;
-        auto resource = std::static_pointer_cast<Resource>(LoadImpl(path));
-        if (resource) {
-            callback(resource);
-        } else {
-            const auto message = std::format("Failed to load resource '{}'", path.string());
-            std::cerr << message << '\n';
-            callback(std::unexpected(message));
+        auto data = Read(path);
+        if (!data) {
+            callback(std::unexpected(data.error()));
+            return;
         }
+        callback(Decode(data.value(), path));
     }
 
-    auto LoadAsync(const fs::path& path, LoaderCallback<Resource> callback) const {
-        if (!ValidateFile(path, callback)) return;
-        auto self = this->shared_from_this();
-        std::jthread([self, path, callback]() {
-            auto resource = std::static_pointer_cast<Resource>(self->LoadImpl(path));
-            if (resource) {
-                callback(resource);
-            } else {
-                const auto message = std::format("Failed to load resource '{}'", path.string());
-                std::cerr << message << '\n';
-                callback(std::unexpected(message));
-            }
-        }).detach();
-    }
-
-    virtual ~Loader() = default;
-
-protected:
-    [[nodiscard]] virtual auto ValidFileExtensions() const -> std::vector<std::string> = 0;
-
-    [[nodiscard]] virtual auto LoadImpl(const fs::path& path) const -> std::shared_ptr<void> = 0;
-
-private:
-    auto ValidateFile(const fs::path& path, LoaderCallback<Resource> callback) const {
+    auto Validate(const fs::path& path) const -> std::expected<void, std::string> {
         if (!ValidateFileType(path)) {
             const auto& str = path.extension().string();
-            const auto message = std::format("Unsupported file type '{}'", str);
-            callback(std::unexpected(message));
-            return false;
+            return std::unexpected(std::format("Unsupported file type '{}'", str));
         }
+        return {};
+    }
 
-        if (!fs::exists(path)) {
-            const auto& str = path.string();
-            const auto message = std::format("File not found '{}'", str);
-            callback(std::unexpected(message));
-            return false;
+    // I/O stage: validates the path and reads its raw bytes into a pooled buffer.
+    auto Read(const fs::path& path) const -> ReadResult {
+        if (auto valid = Validate(path); !valid) {
+            return std::unexpected(valid.error());
         }
+        return BlockingFileReader::Read(path);
+    }
 
-        return true;
+    // CPU stage: turns raw bytes into a resource.
+    auto Decode(const FileData& data, const fs::path& path) const -> LoaderResult<Resource> {
+        auto resource = std::static_pointer_cast<Resource>(DecodeImpl(data.Bytes(), path));
+        if (!resource) {
+            const auto message = std::format("Failed to load resource '{}'", path.string());
+            std::cerr << message << '\n';
+            return std::unexpected(message);
+        }
+        return resource;
     }
 
+    virtual ~Loader() = default;
+
+protected:
+    // Checked on every request, so implementations return static storage.
+    [[nodiscard]] virtual auto ValidFileExtensions() const -> std::span<const std::string_view> = 0;
+
+    [[nodiscard]] virtual auto DecodeImpl(
+        std::span<const unsigned char> bytes,
+        const fs::path& path
+    ) const -> std::shared_ptr<void> = 0;
+
+private:
     auto ValidateFileType(const fs::path& path) const {
-        return std::ranges::any_of(ValidFileExtensions(),
-            [ext = path.extension().string()](const auto& v) {
-                return ext == v;
-            }
-        );
+        const auto& native = path.native();
+        return std::ranges::any_of(ValidFileExtensions(), [&native](std::string_view ext) {
+            return native.size() >= ext.size() &&
+                   std::equal(ext.rbegin(), ext.rend(), native.rbegin());
+        });
     }
 
 };
\ No newline at end of file
@@ -0,0 +1,157 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "png_writer.h"
+
+#include <array>
+#include <format>
+
+// Stored deflate blocks hold at most 65535 bytes.
+static constexpr std::size_t kBlockBytes {65535};
+
+static constexpr std::size_t kChunkBytes {1024 * 1024};
+
+// Largest run of bytes the Adler-32 sums can take before they overflow.
+static constexpr std::size_t kAdlerRun {5552};
+
+static constexpr std::array<unsigned char, 8> kSignature {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+static constexpr auto kCrcTable = [] {
+    auto table = std::array<std::uint32_t, 256> {};
+    for (auto n = std::uint32_t {0}; n < table.size(); ++n) {
+        auto c = n;
+        for (auto k = 0; k < 8; ++k) c = (c & 1) != 0 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[n] = c;
+    }
+    return table;
+}();
+
+static auto crc32(std::uint32_t crc, std::span<const unsigned char> bytes) -> std::uint32_t {
+    for (const auto byte : bytes) crc = kCrcTable[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static auto appendBigEndian(std::vector<unsigned char>& out, std::uint32_t value) -> void {
+    out.insert(out.end(), {
+        static_cast<unsigned char>(value >> 24),
+        static_cast<unsigned char>(value >> 16),
+        static_cast<unsigned char>(value >> 8),
+        static_cast<unsigned char>(value)
+    });
+}
+
+auto PngWriter::Open(
+    const fs::path& path,
+    std::uint32_t width,
+    std::uint32_t height,
+    std::uint32_t channels
+) -> std::expected<PngWriter, std::string> {
+    static constexpr std::array<unsigned char, 5> kColorTypes {0, 0, 4, 2, 6};
+    if (width == 0 || height == 0 || channels == 0 || channels > 4) {
+        return std::unexpected(std::format("Cannot write a {}x{} image with {} channels", width, height, channels));
+    }
+
+    auto writer = PngWriter {};
+    writer.file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!writer.file_) {
+        return std::unexpected(std::format("Failed to open '{}' for writing", path.string()));
+    }
+    writer.path_ = path;
+    writer.width_ = width;
+    writer.height_ = height;
+    writer.channels_ = channels;
+    writer.block_.reserve(kBlockBytes);
+    writer.chunk_.reserve(kChunkBytes + kBlockBytes + 5);
+
+    writer.file_.write(reinterpret_cast<const char*>(kSignature.data()), kSignature.size());
+
+    auto header = std::vector<unsigned char> {};
+    appendBigEndian(header, width);
+    appendBigEndian(header, height);
+    header.insert(header.end(), {8, kColorTypes[channels], 0, 0, 0});
+    writer.WriteChunk("IHDR", header);
+
+    // zlib header: deflate with a 32K window, no preset dictionary.
+    writer.chunk_.insert(writer.chunk_.end(), {0x78, 0x01});
+    return writer;
+}
+
+auto PngWriter::WriteRows(std::span<const unsigned char> rows) -> void {
+    const auto row_bytes = RowBytes();
+    static constexpr auto kNoFilter = std::array<unsigned char, 1> {0};
+    for (auto offset = std::size_t {0}; offset + row_bytes <= rows.size() && rows_written_ < height_; offset += row_bytes) {
+        Append(kNoFilter);
+        Append(rows.subspan(offset, row_bytes));
+        ++rows_written_;
+    }
+}
+
+auto PngWriter::Finish() -> std::expected<void, std::string> {
+    if (rows_written_ != height_) {
+        return std::unexpected(std::format("'{}' got {} of {} rows", path_.string(), rows_written_, height_));
+    }
+
+    EndBlock(true);
+    appendBigEndian(chunk_, (adler_b_ << 16) | adler_a_);
+    WriteChunk("IDAT", chunk_);
+    chunk_.clear();
+    WriteChunk("IEND", {});
+
+    file_.close();
+    if (!file_) return std::unexpected(std::format("Failed to write '{}'", path_.string()));
+    return {};
+}
+
+auto PngWriter::Append(std::span<const unsigned char> bytes) -> void {
+    while (!bytes.empty()) {
+        const auto count = std::min(bytes.size(), kBlockBytes - block_.size());
+        const auto part = bytes.first(count);
+        block_.insert(block_.end(), part.begin(), part.end());
+
+        for (auto run = std::size_t {0}; run < part.size(); run += kAdlerRun) {
+            for (const auto byte : part.subspan(run, std::min(kAdlerRun, part.size() - run))) {
+                adler_a_ += byte;
+                adler_b_ += adler_a_;
+            }
+            adler_a_ %= 65521;
+            adler_b_ %= 65521;
+        }
+
+        bytes = bytes.subspan(count);
+        if (block_.size() == kBlockBytes) EndBlock(false);
+    }
+}
+
+auto PngWriter::EndBlock(bool last) -> void {
+    const auto length = static_cast<std::uint16_t>(block_.size());
+    const auto complement = static_cast<std::uint16_t>(~length);
+    chunk_.insert(chunk_.end(), {
+        static_cast<unsigned char>(last ? 1 : 0),
+        static_cast<unsigned char>(length & 0xFF),
+        static_cast<unsigned char>(length >> 8),
+        static_cast<unsigned char>(complement & 0xFF),
+        static_cast<unsigned char>(complement >> 8)
+    });
+    chunk_.insert(chunk_.end(), block_.begin(), block_.end());
+    block_.clear();
+
+    if (!last && chunk_.size() >= kChunkBytes) {
+        WriteChunk("IDAT", chunk_);
+        chunk_.clear();
+    }
+}
+
+auto PngWriter::WriteChunk(const char (&type)[5], std::span<const unsigned char> data) -> void {
+    auto prefix = std::vector<unsigned char> {};
+    appendBigEndian(prefix, static_cast<std::uint32_t>(data.size()));
+    prefix.insert(prefix.end(), type, type + 4);
+
+    auto crc = crc32(0xFFFFFFFFu, std::span {prefix}.subspan(4));
+    crc = crc32(crc, data) ^ 0xFFFFFFFFu;
+    auto suffix = std::vector<unsigned char> {};
+    appendBigEndian(suffix, crc);
+
+    file_.write(reinterpret_cast<const char*>(prefix.data()), static_cast<std::streamsize>(prefix.size()));
+    file_.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    file_.write(reinterpret_cast<const char*>(suffix.data()), static_cast<std::streamsize>(suffix.size()));
+}
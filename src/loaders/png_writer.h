@@ -0,0 +1,66 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Writes an 8-bit PNG a few rows at a time, so that images far larger than
+// memory can be written as they are produced. Rows are stored in
+// uncompressed deflate blocks, which costs file size but no CPU and no
+// buffer beyond one IDAT chunk.
+class PngWriter {
+public:
+    // Channels are 1 (gray), 2 (gray and alpha), 3 (RGB) or 4 (RGBA).
+    [[nodiscard]] static auto Open(
+        const fs::path& path,
+        std::uint32_t width,
+        std::uint32_t height,
+        std::uint32_t channels
+    ) -> std::expected<PngWriter, std::string>;
+
+    // Appends whole rows, top to bottom, each width * channels bytes.
+    auto WriteRows(std::span<const unsigned char> rows) -> void;
+
+    // Ends the image. Fails if fewer rows than the height were written or
+    // the file could not be written.
+    [[nodiscard]] auto Finish() -> std::expected<void, std::string>;
+
+    [[nodiscard]] auto RowBytes() const -> std::size_t {
+        return static_cast<std::size_t>(width_) * channels_;
+    }
+
+private:
+    std::ofstream file_;
+    fs::path path_;
+
+    std::uint32_t width_ {0};
+    std::uint32_t height_ {0};
+    std::uint32_t channels_ {0};
+    std::uint32_t rows_written_ {0};
+
+    // Raw bytes of the current stored block, and the deflate stream
+    // waiting to be written as the next IDAT chunk.
+    std::vector<unsigned char> block_;
+    std::vector<unsigned char> chunk_;
+
+    std::uint32_t adler_a_ {1};
+    std::uint32_t adler_b_ {0};
+
+    PngWriter() = default;
+
+    auto Append(std::span<const unsigned char> bytes) -> void;
+
+    auto EndBlock(bool last) -> void;
+
+    auto WriteChunk(const char (&type)[5], std::span<const unsigned char> data) -> void;
+};
@@ -0,0 +1,370 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+
+#include "pyramid_generator.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <print>
+
+#include <stb_image_write.h>
+
+#include "core/buffer_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PYRAMID_GENERATOR_SSE2
+#endif
+
+static auto packKey(const TileId& id) -> std::uint64_t {
+    return (static_cast<std::uint64_t>(id.lod) << 48) |
+           (static_cast<std::uint64_t>(id.y) << 24) |
+           static_cast<std::uint64_t>(id.x);
+}
+
+#ifdef PYRAMID_GENERATOR_SSE2
+// Each loop turns 8 source pixels of two rows into 4 RGBA pixels, adding in
+// 16 bits so that the rounding matches the scalar path exactly.
+static auto averageRgba(const unsigned char* row0, const unsigned char* row1, unsigned char* out, std::size_t pairs) -> std::size_t {
+    const auto zero = _mm_setzero_si128();
+    const auto two = _mm_set1_epi16(2);
+    auto i = std::size_t {0};
+    for (; i + 4 <= pairs; i += 4) {
+        const auto a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i * 8));
+        const auto a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i * 8 + 16));
+        const auto b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i * 8));
+        const auto b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i * 8 + 16));
+
+        // Vertical sums of pixels 0-1, 2-3, 4-5 and 6-7.
+        const auto s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+        const auto s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+        const auto s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+        const auto s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+        // Each pixel plus its right neighbour.
+        const auto lo = _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+        const auto hi = _mm_add_epi16(_mm_unpacklo_epi64(s2, s3), _mm_unpackhi_epi64(s2, s3));
+
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(out + i * 4),
+            _mm_packus_epi16(
+                _mm_srli_epi16(_mm_add_epi16(lo, two), 2),
+                _mm_srli_epi16(_mm_add_epi16(hi, two), 2)
+            )
+        );
+    }
+    return i;
+}
+
+// Each loop turns 32 source pixels of two rows into 16 gray pixels.
+static auto averageGray(const unsigned char* row0, const unsigned char* row1, unsigned char* out, std::size_t pairs) -> std::size_t {
+    const auto low_bytes = _mm_set1_epi16(0x00FF);
+    const auto two = _mm_set1_epi16(2);
+    const auto pairSums = [&](const unsigned char* a, const unsigned char* b) {
+        const auto top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        const auto bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        const auto sum = _mm_add_epi16(
+            _mm_add_epi16(_mm_and_si128(top, low_bytes), _mm_srli_epi16(top, 8)),
+            _mm_add_epi16(_mm_and_si128(bottom, low_bytes), _mm_srli_epi16(bottom, 8))
+        );
+        return _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+    };
+
+    auto i = std::size_t {0};
+    for (; i + 16 <= pairs; i += 16) {
+        const auto lo = pairSums(row0 + i * 2, row1 + i * 2);
+        const auto hi = pairSums(row0 + i * 2 + 16, row1 + i * 2 + 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+#endif
+
+template <typename T>
+static auto averageRow(const T* row0, const T* row1, T* out, unsigned width, unsigned depth) -> void {
+    auto first = std::size_t {0};
+#ifdef PYRAMID_GENERATOR_SSE2
+    if constexpr (sizeof(T) == 1) {
+        if (depth == 4) first = averageRgba(row0, row1, out, width / 2);
+        if (depth == 1) first = averageGray(row0, row1, out, width / 2);
+    }
+#endif
+
+    for (auto x = first; x < (width + 1) / 2; ++x) {
+        const auto left = 2 * x * depth;
+        const auto right = std::min<std::size_t>(2 * x + 1, width - 1) * depth;
+        for (auto c = std::size_t {0}; c < depth; ++c) {
+            const auto sum = std::uint32_t {row0[left + c]} + row0[right + c] + row1[left + c] + row1[right + c];
+            out[x * depth + c] = static_cast<T>((sum + 2) / 4);
+        }
+    }
+}
+
+template <typename T>
+static auto downsample(const Image& child, Image& parent, unsigned x, unsigned y) -> void {
+    const auto rows = (child.height + 1) / 2;
+    for (auto row = 0u; row < rows; ++row) {
+        const auto top = std::min(2 * row, child.height - 1);
+        const auto bottom = std::min(2 * row + 1, child.height - 1);
+        averageRow(
+            reinterpret_cast<const T*>(child.Data() + top * child.RowBytes()),
+            reinterpret_cast<const T*>(child.Data() + bottom * child.RowBytes()),
+            reinterpret_cast<T*>(parent.Data() + (y + row) * parent.RowBytes() + x * parent.BytesPerPixel()),
+            child.width,
+            child.depth
+        );
+    }
+}
+
+PyramidGenerator::PyramidGenerator(
+    std::shared_ptr<TileSource> source,
+    std::shared_ptr<Loader<Image>> decoder,
+    const PyramidManifest::Geometry& geometry,
+    const Config& config
+) :
+    source_(std::move(source)),
+    decoder_(std::move(decoder)),
+    geometry_(geometry),
+    config_(config),
+    jobs_(config.queue_capacity),
+    ready_(config.queue_capacity)
+{
+    for (auto i = 0u; i < config.workers; ++i) {
+        workers_.emplace_back([this] {
+            auto reader = source_->CreateBlockingReader();
+            while (auto id = jobs_.Pop()) {
+                if (!ready_.Push({id.value(), Produce(id.value(), *reader)})) return;
+            }
+        });
+    }
+}
+
+auto PyramidGenerator::Generate(const TileId& id, LoaderCallback<Image> callback) -> bool {
+    const auto key = packKey(id);
+    if (const auto it = waiting_.find(key); it != waiting_.end()) {
+        it->second.emplace_back(std::move(callback));
+        ++coalesced_;
+        return true;
+    }
+
+    auto job = id;
+    if (!jobs_.TryPush(std::move(job))) return false;
+    waiting_[key].emplace_back(std::move(callback));
+    return true;
+}
+
+auto PyramidGenerator::GenerateNow(const TileId& id, FileReader& reader) -> LoaderResult<Image> {
+    return Produce(id, reader);
+}
+
+auto PyramidGenerator::ProcessReady() -> std::size_t {
+    auto processed = std::size_t {0};
+    while (auto ready = ready_.TryPop()) {
+        const auto it = waiting_.find(packKey(ready->id));
+        if (it == waiting_.end()) continue;
+        auto callbacks = std::move(it->second);
+        waiting_.erase(it);
+        for (const auto& callback : callbacks) callback(ready->result);
+        ++processed;
+    }
+    return processed;
+}
+
+auto PyramidGenerator::GetStats() const -> Stats {
+    return {
+        .generated = generated_.load(),
+        .coalesced = coalesced_.load(),
+        .persisted = persisted_.load()
+    };
+}
+
+auto PyramidGenerator::Downsample(const Image& child, Image& parent, unsigned x, unsigned y) -> void {
+    if (child.bit_depth == 16) {
+        downsample<std::uint16_t>(child, parent, x, y);
+    } else {
+        downsample<std::uint8_t>(child, parent, x, y);
+    }
+}
+
+auto PyramidGenerator::Produce(const TileId& id, FileReader& reader) -> LoaderResult<Image> {
+    const auto key = packKey(id);
+    auto promise = std::promise<LoaderResult<Image>> {};
+
+    auto lock = std::unique_lock {mutex_};
+    for (const auto& [recent_key, image] : recent_) {
+        if (recent_key == key) return image;
+    }
+    if (const auto it = building_.find(key); it != building_.end()) {
+        // Whoever builds it only waits on finer tiles, so this cannot cycle.
+        const auto pending = it->second;
+        lock.unlock();
+        ++coalesced_;
+        return pending.get();
+    }
+    building_.emplace(key, promise.get_future().share());
+    lock.unlock();
+
+    auto result = Build(id, reader);
+
+    lock.lock();
+    if (result) {
+        recent_.emplace_back(key, result.value());
+        if (recent_.size() > config_.recent_tiles) {
+            // Coarser tiles took more work to build, so the oldest of the
+            // finest go first.
+            recent_.erase(std::ranges::min_element(recent_, {}, [](const auto& entry) {
+                return entry.first >> 48;
+            }));
+        }
+    }
+    building_.erase(key);
+    lock.unlock();
+
+    promise.set_value(result);
+    return result;
+}
+
+auto PyramidGenerator::Build(const TileId& id, FileReader& reader) -> LoaderResult<Image> {
+    if (id.lod == 0 || id.lod >= static_cast<unsigned>(geometry_.lods)) {
+        return std::unexpected(std::format("No finer level to build tile {} from", id));
+    }
+
+    // Children outside the finer level's grid stay null and take no space.
+    const auto lod = id.lod - 1;
+    auto children = std::array<std::shared_ptr<Image>, 4> {};
+    auto ids = std::array<TileId, 4> {};
+    auto paths = std::vector<fs::path> {};
+    auto slots = std::vector<std::size_t> {};
+    for (auto i = std::size_t {0}; i < children.size(); ++i) {
+        ids[i] = {lod, id.x * 2 + static_cast<int>(i % 2), id.y * 2 + static_cast<int>(i / 2)};
+        if (ids[i].x >= TilesX(lod) || ids[i].y >= TilesY(lod)) continue;
+        paths.emplace_back(source_->Locate(ids[i]));
+        slots.emplace_back(i);
+    }
+
+    // A child that is absent, and cannot be built, leaves its quadrant
+    // empty; only a read or decode error fails the parent.
+    auto results = reader.ReadBatch(paths);
+    auto absent = false;
+    for (auto i = std::size_t {0}; i < slots.size(); ++i) {
+        const auto slot = slots[i];
+        if (results[i]) {
+            auto decoded = decoder_->Decode(results[i].value(), paths[i]);
+            if (!decoded) return std::unexpected(decoded.error());
+            children[slot] = std::move(decoded.value());
+            continue;
+        }
+        if (!IsNotFound(results[i].error())) return std::unexpected(results[i].error());
+
+        if (lod > 0) {
+            auto built = Produce(ids[slot], reader);
+            if (built) {
+                children[slot] = std::move(built.value());
+                continue;
+            }
+            if (!IsNotFound(built.error())) return built;
+        }
+        absent = true;
+    }
+
+    const auto first = std::ranges::find_if(children, [](const auto& child) { return child != nullptr; });
+    if (first == children.end()) {
+        return std::unexpected(std::format("{} for tile {} or any tile below it", kFileNotFound, id));
+    }
+    for (const auto& child : children) {
+        if (child && (child->depth != (*first)->depth || child->bit_depth != (*first)->bit_depth)) {
+            return std::unexpected(std::format("Children of tile {} differ in format", id));
+        }
+    }
+
+    // Absent children take the size the pyramid's geometry gives them.
+    const auto expected = [&](int full, int index) {
+        const auto level = (full + (1 << lod) - 1) >> lod;
+        return static_cast<unsigned>(std::clamp(level - index * geometry_.tile_size, 0, geometry_.tile_size));
+    };
+    const auto half_width = [&](std::size_t i) {
+        if (ids[i].x >= TilesX(lod)) return 0u;
+        return ((children[i] ? children[i]->width : expected(geometry_.width, ids[i].x)) + 1) / 2;
+    };
+    const auto half_height = [&](std::size_t i) {
+        if (ids[i].y >= TilesY(lod)) return 0u;
+        return ((children[i] ? children[i]->height : expected(geometry_.height, ids[i].y)) + 1) / 2;
+    };
+    const auto left = half_width(0);
+    const auto top = half_height(0);
+    const auto width = left + half_width(1);
+    const auto height = top + half_height(2);
+
+    const auto bytes = static_cast<std::size_t>(width) * height * (*first)->BytesPerPixel();
+    auto parent = std::make_shared<Image>(
+        Image::Parameters {
+            .filename = std::format("{}.png", id),
+            .width = static_cast<int>(width),
+            .height = static_cast<int>(height),
+            .depth = static_cast<int>((*first)->depth),
+            .bit_depth = static_cast<int>((*first)->bit_depth)
+        },
+        ImageData {
+            static_cast<unsigned char*>(BufferPool::Get().Allocate(bytes)),
+            [](void* ptr) { BufferPool::Get().Free(ptr); }
+        }
+    );
+
+    if (absent) std::memset(parent->Data(), 0, bytes);
+
+    const auto offsets = std::array<std::array<unsigned, 2>, 4> {{{0, 0}, {left, 0}, {0, top}, {left, top}}};
+    for (auto i = std::size_t {0}; i < children.size(); ++i) {
+        if (children[i]) Downsample(*children[i], *parent, offsets[i][0], offsets[i][1]);
+    }
+
+    ++generated_;
+    if (config_.persist) Persist(id, *parent);
+    return parent;
+}
+
+auto PyramidGenerator::Persist(const TileId& id, const Image& image) -> void {
+    if (image.bit_depth != 8) return;
+
+    // Written aside and renamed, so that readers never see half a file.
+    const auto path = source_->Locate(id);
+    auto temp = path;
+    temp += ".tmp";
+
+    const auto written = stbi_write_png(
+        temp.string().c_str(),
+        static_cast<int>(image.width),
+        static_cast<int>(image.height),
+        static_cast<int>(image.depth),
+        image.Data(),
+        static_cast<int>(image.RowBytes())
+    );
+
+    auto error = std::error_code {};
+    if (written != 0) fs::rename(temp, path, error);
+    if (written == 0 || error) {
+        fs::remove(temp, error);
+        std::println("Failed to save generated tile {}", id);
+        return;
+    }
+    ++persisted_;
+}
+
+auto PyramidGenerator::TilesX(unsigned lod) const -> int {
+    const auto size = static_cast<float>(geometry_.tile_size * (1 << lod));
+    return static_cast<int>(std::ceil(static_cast<float>(geometry_.width) / size));
+}
+
+auto PyramidGenerator::TilesY(unsigned lod) const -> int {
+    const auto size = static_cast<float>(geometry_.tile_size * (1 << lod));
+    return static_cast<int>(std::ceil(static_cast<float>(geometry_.height) / size));
+}
+
+PyramidGenerator::~PyramidGenerator() {
+    jobs_.Close();
+    ready_.Close();
+    workers_.clear();
+}
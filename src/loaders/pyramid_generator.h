@@ -0,0 +1,130 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/bounded_queue.h"
+#include "core/image.h"
+#include "loaders/loader.h"
+#include "sources/pyramid_manifest.h"
+#include "sources/tile_source.h"
+#include "tile.h"
+
+// Builds tiles a source lacks from the level below: each one is the 2x2 box
+// filtered mosaic of its four children, which are read from the source or,
+// when missing too, built the same way. A child the source lacks at every
+// level leaves its quadrant black. Lets a pyramid that ships only LOD 0 be
+// viewed at every LOD.
+//
+// Requests for a tile already being built wait for it rather than building
+// it again, whether they come from the render thread or from workers
+// building parents, and recently built tiles are kept for the parents that
+// need them next. Results are delivered by ProcessReady() on the thread that
+// made the requests.
+class PyramidGenerator {
+public:
+    struct Config {
+        unsigned workers {std::max(1u, std::thread::hardware_concurrency() / 2)};
+        std::size_t queue_capacity {64};
+
+        // Built tiles kept in memory for the parents that need them next,
+        // and for zooming in on the tiles that were built for them.
+        std::size_t recent_tiles {16};
+
+        // Writes built 8-bit tiles where the source locates them, so that
+        // later runs read them like any other tile. Only for sources whose
+        // locations are local files.
+        bool persist {false};
+    };
+
+    struct Stats {
+        std::size_t generated {0};
+        std::size_t coalesced {0};
+        std::size_t persisted {0};
+    };
+
+    PyramidGenerator(
+        std::shared_ptr<TileSource> source,
+        std::shared_ptr<Loader<Image>> decoder,
+        const PyramidManifest::Geometry& geometry,
+        const Config& config
+    );
+
+    PyramidGenerator(const PyramidGenerator&) = delete;
+    PyramidGenerator& operator=(const PyramidGenerator&) = delete;
+
+    // Queues the tile, or joins the request already queued for it. Never
+    // blocks; returns false when the queue is full.
+    auto Generate(const TileId& id, LoaderCallback<Image> callback) -> bool;
+
+    // Builds the tile on the calling thread, or waits for the worker
+    // already building it, for callers that cannot go on without it. Safe
+    // to call from any thread; the result is not delivered to callbacks.
+    auto GenerateNow(const TileId& id, FileReader& reader) -> LoaderResult<Image>;
+
+    // Invokes callbacks for finished tiles on the calling thread.
+    auto ProcessReady() -> std::size_t;
+
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+    // Averages each 2x2 block of `child` into `parent`, starting at the
+    // given pixel. A last odd row or column is averaged with itself. Both
+    // images must have the same channels and bit depth.
+    static auto Downsample(const Image& child, Image& parent, unsigned x, unsigned y) -> void;
+
+    ~PyramidGenerator();
+
+private:
+    struct Ready {
+        TileId id;
+        LoaderResult<Image> result;
+    };
+
+    std::shared_ptr<TileSource> source_;
+    std::shared_ptr<Loader<Image>> decoder_;
+    PyramidManifest::Geometry geometry_;
+    Config config_;
+
+    // Requests made through Generate(), by tile. Only touched by the
+    // requesting thread.
+    std::unordered_map<std::uint64_t, std::vector<LoaderCallback<Image>>> waiting_;
+
+    // Tiles workers are building, and the ones they built last.
+    std::mutex mutex_;
+    std::unordered_map<std::uint64_t, std::shared_future<LoaderResult<Image>>> building_;
+    std::deque<std::pair<std::uint64_t, std::shared_ptr<Image>>> recent_;
+
+    std::atomic<std::size_t> generated_ {0};
+    std::atomic<std::size_t> coalesced_ {0};
+    std::atomic<std::size_t> persisted_ {0};
+
+    BoundedQueue<TileId> jobs_;
+    BoundedQueue<Ready> ready_;
+
+    // Declared last so that the workers are joined before what they use.
+    std::vector<std::jthread> workers_;
+
+    // Builds the tile, or waits for the worker already building it.
+    auto Produce(const TileId& id, FileReader& reader) -> LoaderResult<Image>;
+
+    auto Build(const TileId& id, FileReader& reader) -> LoaderResult<Image>;
+
+    auto Persist(const TileId& id, const Image& image) -> void;
+
+    [[nodiscard]] auto TilesX(unsigned lod) const -> int;
+
+    [[nodiscard]] auto TilesY(unsigned lod) const -> int;
+};
@@ -0,0 +1,69 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "tile_cache.h"
+
+#include <utility>
+
+TileCache::TileCache(std::size_t max_bytes) : max_bytes_(max_bytes) {}
+
+auto TileCache::Attach(
+    const std::shared_ptr<TileCache>& cache,
+    LoadPipeline<Image>::Config& config
+) -> void {
+    config.lookup = [cache, next = std::move(config.lookup)](const fs::path& path) {
+        if (auto image = cache->Find(path)) return image;
+        auto image = next ? next(path) : nullptr;
+        if (image) cache->Insert(path, image);
+        return image;
+    };
+    config.store = [cache, next = std::move(config.store)](const fs::path& path, const std::shared_ptr<Image>& image) {
+        cache->Insert(path, image);
+        if (next) next(path, image);
+    };
+}
+
+auto TileCache::Find(const fs::path& path) -> std::shared_ptr<Image> {
+    auto lock = std::scoped_lock {mutex_};
+    const auto it = entries_.find(path.string());
+    if (it == entries_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    ++hits_;
+    return it->second->image;
+}
+
+auto TileCache::Insert(const fs::path& path, std::shared_ptr<Image> image) -> void {
+    if (image == nullptr || image->Bytes() > max_bytes_) return;
+
+    auto key = path.string();
+    auto lock = std::scoped_lock {mutex_};
+    if (const auto it = entries_.find(key); it != entries_.end()) {
+        bytes_ -= it->second->image->Bytes();
+        lru_.erase(it->second);
+        entries_.erase(it);
+    }
+
+    bytes_ += image->Bytes();
+    lru_.emplace_front(Entry {.key = key, .image = std::move(image)});
+    entries_.emplace(std::move(key), lru_.begin());
+
+    while (bytes_ > max_bytes_) {
+        const auto& oldest = lru_.back();
+        bytes_ -= oldest.image->Bytes();
+        entries_.erase(oldest.key);
+        lru_.pop_back();
+    }
+}
+
+auto TileCache::GetStats() const -> Stats {
+    auto lock = std::scoped_lock {mutex_};
+    return {
+        .hits = hits_.load(),
+        .misses = misses_.load(),
+        .entries = entries_.size(),
+        .bytes = bytes_
+    };
+}
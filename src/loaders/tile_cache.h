@@ -0,0 +1,64 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "core/image.h"
+#include "loaders/load_pipeline.h"
+
+namespace fs = std::filesystem;
+
+// Decoded tiles kept in memory, least recently used first out, keyed by the
+// path they were decoded from. Meant for processes that read regions: shared
+// by a RegionReader and any pipeline attached to it, a tile one of them
+// decoded is not decoded again by the other. Thread-safe.
+class TileCache {
+public:
+    struct Stats {
+        std::size_t hits {0};
+        std::size_t misses {0};
+        std::size_t entries {0};
+        std::size_t bytes {0};
+    };
+
+    explicit TileCache(std::size_t max_bytes = std::size_t {512} * 1024 * 1024);
+
+    // Points the pipeline's lookup and store hooks at the cache, in front
+    // of whatever hooks it had: misses fall through to them, and what they
+    // find is kept here too.
+    static auto Attach(const std::shared_ptr<TileCache>& cache, LoadPipeline<Image>::Config& config) -> void;
+
+    TileCache(const TileCache&) = delete;
+    TileCache& operator=(const TileCache&) = delete;
+
+    [[nodiscard]] auto Find(const fs::path& path) -> std::shared_ptr<Image>;
+
+    auto Insert(const fs::path& path, std::shared_ptr<Image> image) -> void;
+
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<Image> image;
+    };
+
+    std::size_t max_bytes_ {0};
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+    std::size_t bytes_ {0};
+
+    std::atomic<std::size_t> hits_ {0};
+    std::atomic<std::size_t> misses_ {0};
+};
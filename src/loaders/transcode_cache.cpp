@@ -0,0 +1,185 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "transcode_cache.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr std::array<char, 4> kMagic {'T', 'S', 'T', 'C'};
+static constexpr std::uint32_t kVersion {1};
+
+// Pixels are stored uncompressed. The codec field leaves room for
+// compressed payloads in later versions.
+static constexpr std::uint32_t kCodecRaw {0};
+
+// Entries start with a header padded to 64 bytes, so that the mapped
+// pixels keep any row alignment the upload might use.
+struct EntryHeader {
+    std::array<char, 4> magic {kMagic};
+    std::uint32_t version {kVersion};
+    std::uint64_t source_size {0};
+    std::int64_t source_time {0};
+    std::uint32_t width {0};
+    std::uint32_t height {0};
+    std::uint32_t depth {0};
+    std::uint32_t bit_depth {0};
+    std::uint32_t codec {kCodecRaw};
+    std::array<std::uint8_t, 20> reserved {};
+};
+
+static_assert(sizeof(EntryHeader) == 64);
+
+struct SourceStamp {
+    std::uint64_t size {0};
+    std::int64_t time {0};
+};
+
+static auto stampOf(const fs::path& source) -> std::optional<SourceStamp> {
+    auto error = std::error_code {};
+    const auto size = fs::file_size(source, error);
+    if (error) return std::nullopt;
+    const auto time = fs::last_write_time(source, error);
+    if (error) return std::nullopt;
+    return SourceStamp {.size = size, .time = time.time_since_epoch().count()};
+}
+
+static auto keyFor(const fs::path& source) -> std::string {
+    return fs::absolute(source).lexically_normal().string() + ".raw";
+}
+
+#ifndef _WIN32
+// Maps the whole entry read-only. The pages are read in ahead of the
+// upload, which touches all of them.
+static auto mapEntry(const fs::path& path) -> std::shared_ptr<const unsigned char> {
+    const auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat info {};
+    auto data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(EntryHeader))) {
+        data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+
+    const auto length = static_cast<std::size_t>(info.st_size);
+    madvise(data, length, MADV_WILLNEED);
+    return {static_cast<const unsigned char*>(data), [length](const unsigned char* p) {
+        munmap(const_cast<unsigned char*>(p), length);
+    }};
+}
+#else
+static auto mapEntry(const fs::path& path) -> std::shared_ptr<const unsigned char> {
+    auto data = BlockingFileReader::Read(path);
+    if (!data || data->size < sizeof(EntryHeader)) return nullptr;
+    auto owned = std::make_shared<FileData>(std::move(data.value()));
+    return {owned, owned->bytes.get()};
+}
+#endif
+
+TranscodeCache::TranscodeCache(const Config& config) :
+    cache_(config.directory, config.max_bytes),
+    write_queue_(config.write_queue_capacity),
+    writer_([this] {
+        while (auto job = write_queue_.Pop()) Write(job.value());
+    }) {}
+
+auto TranscodeCache::Attach(
+    const std::shared_ptr<TranscodeCache>& cache,
+    LoadPipeline<Image>::Config& config
+) -> void {
+    config.lookup = [cache](const fs::path& path) { return cache->Find(path); };
+    config.store = [cache](const fs::path& path, const std::shared_ptr<Image>& image) {
+        cache->Store(path, image);
+    };
+}
+
+auto TranscodeCache::Find(const fs::path& source) -> std::shared_ptr<Image> {
+    const auto stamp = stampOf(source);
+    const auto path = stamp ? cache_.Locate(keyFor(source)) : std::nullopt;
+    const auto entry = path ? mapEntry(path.value()) : nullptr;
+    if (entry == nullptr) {
+        ++misses_;
+        return nullptr;
+    }
+
+    auto header = EntryHeader {};
+    std::memcpy(&header, entry.get(), sizeof(header));
+
+    const auto pixel_bytes = static_cast<std::uint64_t>(header.width) * header.height *
+        header.depth * (header.bit_depth / 8);
+    auto error = std::error_code {};
+    const auto valid = header.magic == kMagic &&
+        header.version == kVersion &&
+        header.codec == kCodecRaw &&
+        header.source_size == stamp->size &&
+        header.source_time == stamp->time &&
+        (header.bit_depth == 8 || header.bit_depth == 16) &&
+        header.depth >= 1 && header.depth <= 4 &&
+        fs::file_size(path.value(), error) == sizeof(header) + pixel_bytes;
+    if (!valid) {
+        ++misses_;
+        return nullptr;
+    }
+
+    // The image keeps the mapping alive; uploads read straight from it.
+    auto pixels = const_cast<unsigned char*>(entry.get() + sizeof(header));
+    ++hits_;
+    return std::make_shared<Image>(Image::Parameters {
+        .filename = source.filename().string(),
+        .width = static_cast<int>(header.width),
+        .height = static_cast<int>(header.height),
+        .depth = static_cast<int>(header.depth),
+        .bit_depth = static_cast<int>(header.bit_depth)
+    }, ImageData {pixels, [entry](void*) {}});
+}
+
+auto TranscodeCache::Store(const fs::path& source, std::shared_ptr<Image> image) -> void {
+    if (image == nullptr || image->Data() == nullptr) return;
+    if (!write_queue_.TryPush(WriteJob {.source = source, .image = std::move(image)})) {
+        ++dropped_writes_;
+    }
+}
+
+auto TranscodeCache::Write(const WriteJob& job) -> void {
+    const auto stamp = stampOf(job.source);
+    if (!stamp) return;
+
+    const auto& image = *job.image;
+    const auto header = EntryHeader {
+        .source_size = stamp->size,
+        .source_time = stamp->time,
+        .width = image.width,
+        .height = image.height,
+        .depth = image.depth,
+        .bit_depth = image.bit_depth
+    };
+
+    auto bytes = std::vector<unsigned char>(sizeof(header) + image.Bytes());
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    std::memcpy(bytes.data() + sizeof(header), image.Data(), image.Bytes());
+    cache_.Put(keyFor(job.source), bytes);
+    ++writes_;
+}
+
+auto TranscodeCache::GetStats() const -> Stats {
+    return {
+        .hits = hits_.load(),
+        .misses = misses_.load(),
+        .writes = writes_.load(),
+        .dropped_writes = dropped_writes_.load()
+    };
+}
+
+TranscodeCache::~TranscodeCache() {
+    write_queue_.Close();
+}
@@ -0,0 +1,88 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+#include "core/bounded_queue.h"
+#include "core/image.h"
+#include "loaders/load_pipeline.h"
+#include "sources/disk_cache.h"
+
+namespace fs = std::filesystem;
+
+// Decoded tiles kept on disk as raw pixels, ready to upload, so that later
+// runs map them instead of decoding the pyramid again. Each entry records
+// the size and modification time of the file it was decoded from, and is
+// ignored once the source changes.
+//
+// Entries are written by a background thread after the first decode, and
+// dropped rather than waited for when it falls behind.
+class TranscodeCache {
+public:
+    struct Config {
+        fs::path directory {".cache/tiles"};
+        std::uintmax_t max_bytes {std::uintmax_t {4} * 1024 * 1024 * 1024};
+        std::size_t write_queue_capacity {64};
+    };
+
+    struct Stats {
+        std::size_t hits {0};
+        std::size_t misses {0};
+        std::size_t writes {0};
+        std::size_t dropped_writes {0};
+    };
+
+    [[nodiscard]] static auto Create() -> std::shared_ptr<TranscodeCache> {
+        return Create(Config {});
+    }
+
+    [[nodiscard]] static auto Create(const Config& config) -> std::shared_ptr<TranscodeCache> {
+        return std::shared_ptr<TranscodeCache>(new TranscodeCache(config));
+    }
+
+    // Points the pipeline's lookup and store hooks at the cache.
+    static auto Attach(const std::shared_ptr<TranscodeCache>& cache, LoadPipeline<Image>::Config& config) -> void;
+
+    TranscodeCache(const TranscodeCache&) = delete;
+    TranscodeCache& operator=(const TranscodeCache&) = delete;
+
+    // The pixels decoded from the source file, mapped from disk, or nullptr
+    // when they are not cached or the source has changed since.
+    [[nodiscard]] auto Find(const fs::path& source) -> std::shared_ptr<Image>;
+
+    // Queues the image to be written. Never blocks.
+    auto Store(const fs::path& source, std::shared_ptr<Image> image) -> void;
+
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+    ~TranscodeCache();
+
+private:
+    struct WriteJob {
+        fs::path source;
+        std::shared_ptr<Image> image;
+    };
+
+    DiskCache cache_;
+
+    std::atomic<std::size_t> hits_ {0};
+    std::atomic<std::size_t> misses_ {0};
+    std::atomic<std::size_t> writes_ {0};
+    std::atomic<std::size_t> dropped_writes_ {0};
+
+    BoundedQueue<WriteJob> write_queue_;
+
+    // Declared last so that it is joined before what it uses.
+    std::jthread writer_;
+
+    explicit TranscodeCache(const Config& config);
+
+    auto Write(const WriteJob& job) -> void;
+};
@@ -0,0 +1,217 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "uring_file_reader.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "core/buffer_pool.h"
+
+// Marks reads whose completion never arrived.
+static constexpr int kNotCompleted {std::numeric_limits<int>::min()};
+
+static auto setUserData(io_uring_sqe* sqe, std::size_t value) -> void {
+    io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<std::uintptr_t>(value)));
+}
+
+auto UringFileReader::Create() -> std::unique_ptr<UringFileReader> {
+    auto reader = std::unique_ptr<UringFileReader>(new UringFileReader());
+    if (!reader->Initialize()) return nullptr;
+    return reader;
+}
+
+auto UringFileReader::Initialize() -> bool {
+    if (io_uring_queue_init(kMaxBatchSize * 2, &ring_, 0) < 0) {
+        return false;
+    }
+    initialized_ = true;
+
+    buffers_ = std::make_shared<BufferSet>();
+    buffers_->memory = std::make_unique_for_overwrite<unsigned char[]>(
+        kRegisteredBuffers * kRegisteredBufferBytes
+    );
+
+    auto iovecs = std::vector<iovec> {};
+    for (auto i = 0u; i < kRegisteredBuffers; ++i) {
+        iovecs.emplace_back(iovec {
+            .iov_base = buffers_->Data(static_cast<int>(i)),
+            .iov_len = kRegisteredBufferBytes
+        });
+    }
+
+    // Registration can fail under a tight RLIMIT_MEMLOCK; reads then simply
+    // go to pooled buffers instead of fixed ones.
+    if (io_uring_register_buffers(&ring_, iovecs.data(), iovecs.size()) == 0) {
+        for (auto i = static_cast<int>(kRegisteredBuffers) - 1; i >= 0; --i) {
+            buffers_->free_indices.emplace_back(i);
+        }
+    }
+
+    return true;
+}
+
+auto UringFileReader::ReadBatch(std::span<const fs::path> paths) -> std::vector<ReadResult> {
+    if (paths.size() > kMaxBatchSize) {
+        auto results = ReadBatch(paths.first(kMaxBatchSize));
+        for (auto& result : ReadBatch(paths.subspan(kMaxBatchSize))) {
+            results.emplace_back(std::move(result));
+        }
+        return results;
+    }
+
+    const auto count = paths.size();
+    auto names = std::vector<std::string> {};
+    names.reserve(count);
+    for (const auto& path : paths) {
+        names.emplace_back(path.string());
+    }
+
+    auto results = std::vector<ReadResult> {};
+    for (auto i = 0u; i < count; ++i) {
+        results.emplace_back(std::unexpected(
+            broken_ ? std::format("Cannot read '{}' after an io_uring failure", names[i])
+                    : std::format("{} '{}'", kFileNotFound, names[i])
+        ));
+    }
+    if (broken_) return results;
+
+    // Stage 1: open every file and query its size.
+    auto stats = std::vector<struct statx>(count);
+    for (auto i = 0u; i < count; ++i) {
+        auto open_sqe = io_uring_get_sqe(&ring_);
+        io_uring_prep_openat(open_sqe, AT_FDCWD, names[i].c_str(), O_RDONLY | O_CLOEXEC, 0);
+        setUserData(open_sqe, i * 2);
+
+        auto stat_sqe = io_uring_get_sqe(&ring_);
+        io_uring_prep_statx(stat_sqe, AT_FDCWD, names[i].c_str(), 0, STATX_SIZE, &stats[i]);
+        setUserData(stat_sqe, i * 2 + 1);
+    }
+
+    // Descriptors are closed here rather than by the ring, so that every
+    // one that was opened is closed whichever stage fails.
+    auto opened = std::vector<int>(count * 2, -1);
+    const auto closeOpened = [&] {
+        for (auto i = 0u; i < count; ++i) {
+            if (opened[i * 2] >= 0) close(opened[i * 2]);
+        }
+    };
+    if (!SubmitAndWait(count * 2, opened)) {
+        closeOpened();
+        return results;
+    }
+
+    // Stage 2: read every file into a registered or pooled buffer.
+    auto buffers = std::vector<FileData>(count);
+    auto submitted = 0u;
+    for (auto i = 0u; i < count; ++i) {
+        const auto fd = opened[i * 2];
+        if (fd < 0 || opened[i * 2 + 1] < 0) continue;
+
+        const auto size = static_cast<std::size_t>(stats[i].stx_size);
+        auto read_sqe = io_uring_get_sqe(&ring_);
+
+        const auto index = size <= kRegisteredBufferBytes ? buffers_->Acquire() : -1;
+        if (index >= 0) {
+            buffers[i] = FileData {
+                .bytes = FileBuffer {
+                    buffers_->Data(index),
+                    [set = buffers_, index](void*) { set->Release(index); }
+                },
+                .size = size
+            };
+            io_uring_prep_read_fixed(read_sqe, fd, buffers_->Data(index), size, 0, index);
+        } else {
+            buffers[i] = FileData {
+                .bytes = FileBuffer {
+                    static_cast<unsigned char*>(BufferPool::Get().Allocate(size)),
+                    [](void* ptr) { BufferPool::Get().Free(ptr); }
+                },
+                .size = size
+            };
+            io_uring_prep_read(read_sqe, fd, buffers[i].bytes.get(), size, 0);
+        }
+        setUserData(read_sqe, i);
+        ++submitted;
+    }
+
+    auto completions = std::vector<int>(count, kNotCompleted);
+    const auto completed = submitted == 0 || SubmitAndWait(submitted, completions);
+    if (!completed) {
+        // The ring may still write into buffers whose reads never
+        // completed, so those are leaked rather than reused.
+        for (auto i = 0u; i < count; ++i) {
+            if (completions[i] == kNotCompleted) static_cast<void>(buffers[i].bytes.release());
+        }
+    }
+    closeOpened();
+    if (!completed) return results;
+
+    for (auto i = 0u; i < count; ++i) {
+        if (opened[i * 2] < 0 || opened[i * 2 + 1] < 0) continue;
+        if (completions[i] != static_cast<int>(buffers[i].size)) {
+            results[i] = std::unexpected(std::format("Failed to read file '{}'", names[i]));
+            continue;
+        }
+        results[i] = std::move(buffers[i]);
+    }
+
+    return results;
+}
+
+auto UringFileReader::SubmitAndWait(unsigned count, std::vector<int>& results) -> bool {
+    // Every operation is reaped before returning, so that none of this
+    // batch's completions is taken for one of the next batch's. Interrupted
+    // waits and a full completion queue are retried after reaping what
+    // arrived; any other error leaves the ring in an unknown state, and the
+    // reader stops using it.
+    for (auto reaped = 0u; reaped < count;) {
+        const auto error = io_uring_submit_and_wait(&ring_, 1);
+        if (error < 0 && error != -EINTR && error != -EAGAIN && error != -EBUSY) {
+            broken_ = true;
+            return false;
+        }
+
+        auto head = 0u;
+        auto seen = 0u;
+        auto cqe = static_cast<io_uring_cqe*>(nullptr);
+        io_uring_for_each_cqe(&ring_, head, cqe) {
+            const auto slot = reinterpret_cast<std::uintptr_t>(io_uring_cqe_get_data(cqe));
+            if (slot < results.size()) results[slot] = cqe->res;
+            ++seen;
+        }
+        io_uring_cq_advance(&ring_, seen);
+        reaped += seen;
+    }
+
+    return true;
+}
+
+UringFileReader::~UringFileReader() {
+    if (initialized_) io_uring_queue_exit(&ring_);
+}
+
+auto UringFileReader::BufferSet::Acquire() -> int {
+    auto lock = std::scoped_lock {mutex};
+    if (free_indices.empty()) return -1;
+    const auto index = free_indices.back();
+    free_indices.pop_back();
+    return index;
+}
+
+auto UringFileReader::BufferSet::Release(int index) -> void {
+    auto lock = std::scoped_lock {mutex};
+    free_indices.emplace_back(index);
+}
+
+auto UringFileReader::BufferSet::Data(int index) const -> unsigned char* {
+    return memory.get() + static_cast<std::size_t>(index) * kRegisteredBufferBytes;
+}
@@ -0,0 +1,62 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <liburing.h>
+
+#include "loaders/file_reader.h"
+
+// Reads a whole batch of files with a handful of io_uring submissions: one
+// for every open and size query, one for every read.
+// Small files land in buffers registered with the ring and are handed to the
+// decoder as-is; the buffer returns to the reader once the decoder drops it.
+class UringFileReader : public FileReader {
+public:
+    static constexpr std::size_t kMaxBatchSize {32};
+    static constexpr std::size_t kRegisteredBuffers {48};
+    static constexpr std::size_t kRegisteredBufferBytes {1024 * 1024};
+
+    [[nodiscard]] static auto Create() -> std::unique_ptr<UringFileReader>;
+
+    [[nodiscard]] auto ReadBatch(std::span<const fs::path> paths) -> std::vector<ReadResult> override;
+
+    [[nodiscard]] auto MaxBatchSize() const -> std::size_t override {
+        return kMaxBatchSize;
+    }
+
+    ~UringFileReader() override;
+
+private:
+    // Outlives the reader for as long as a decoder still holds one of its buffers.
+    struct BufferSet {
+        std::unique_ptr<unsigned char[]> memory;
+        std::vector<int> free_indices;
+        std::mutex mutex;
+
+        auto Acquire() -> int;
+        auto Release(int index) -> void;
+        auto Data(int index) const -> unsigned char*;
+    };
+
+    io_uring ring_ {};
+
+    std::shared_ptr<BufferSet> buffers_;
+
+    bool initialized_ {false};
+
+    // Set once the ring fails in a way that leaves operations unaccounted
+    // for; every later batch fails without touching it.
+    bool broken_ {false};
+
+    UringFileReader() = default;
+
+    auto Initialize() -> bool;
+
+    auto SubmitAndWait(unsigned count, std::vector<int>& results) -> bool;
+};
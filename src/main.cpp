@@ -1,35 +1,230 @@
 // Copyright © 2025 - Present, Shlomi Nissan.
 // All rights reserved.
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <filesystem>
+#include <memory>
+#include <optional>
 #include <print>
+#include <string_view>
 #include <vector>
 
 #include <imgui.h>
 
+#include "core/frame_governor.h"
 #include "core/orthographic_camera.h"
-#include "core/shaders.h"
+#include "core/program_cache.h"
+#include "core/timer.h"
+#include "core/upload_thread.h"
 #include "core/window.h"
-#include "geometries/plane_geometry.h"
+#include "loaders/image_loader.h"
+#include "loaders/load_pipeline.h"
+#include "loaders/pyramid_generator.h"
+#include "loaders/transcode_cache.h"
 #include "resources/zoom_pan_camera.h"
+#include "sources/file_tile_source.h"
 
+#ifdef TILE_STREAMING_HAS_HTTP
+#include "sources/http_tile_source.h"
+#endif
+
+#include "layer_stack.h"
+#include "region_exporter.h"
 #include "tile_manager.h"
+#include "tile_renderer.h"
+#include "tile_textures.h"
 #include "types.h"
+#include "viewport.h"
+#include "virtual_texture.h"
+
+// Parses "x,y,width,height" in LOD 0 pixels.
+static auto parseRegion(std::string_view text) -> std::optional<Box2> {
+    auto values = std::array<float, 4> {};
+    for (auto& value : values) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc {}) return std::nullopt;
+        text.remove_prefix(static_cast<std::size_t>(end - text.data()));
+        if (!text.empty() && text.front() == ',') text.remove_prefix(1);
+    }
+    if (!text.empty() || values[2] <= 0.0f || values[3] <= 0.0f) return std::nullopt;
+    return Box2 {{values[0], values[1]}, {values[0] + values[2], values[1] + values[3]}};
+}
 
-#include "shaders/headers/tile_frag.h"
-#include "shaders/headers/tile_vert.h"
+auto main([[maybe_unused]] int argc, [[maybe_unused]] char** argv) -> int {
+    const auto startup = Timer {};
 
-auto main() -> int {
     const auto window_dims = Dimensions {1024.0f, 1024.0f};
     const auto texture_dims = Dimensions {8192.0f, 8192.0f};
     const auto tile_size = 1024.0f;
     const auto lods = 4;
 
-    auto tile_manager = TileManager {
-        texture_dims,
-        window_dims,
-        tile_size,
-        lods
+    // Tiles come from the local pyramid unless a tile server URL is given,
+    // e.g. `tile_streaming http://localhost:8080/tiles`. `--upload-thread`
+    // moves texture uploads to a background context, and `--virtual-texture`
+    // draws the image in one pass through a page table, streaming the tiles
+    // the GPU reports it sampled. Each `--layer <dir>` overlays another
+    // co-registered local pyramid. `--viewports <n>` splits the window into
+    // side-by-side views of the image that share one tile cache, moving
+    // together with `--link-viewports`. `--no-tile-cache` decodes every
+    // tile instead of mapping the pixels earlier runs decoded.
+    // `--generate-lods` builds coarser tiles the pyramid lacks from finer
+    // ones, and `--persist-lods` also saves them next to the local tiles.
+    // `--export x,y,w,h` writes that region, in LOD 0 pixels, to the PNG
+    // named by `--export-to` at the LOD given by `--export-lod`, without
+    // opening a window.
+    auto source = std::shared_ptr<TileSource> {
+        std::make_shared<FileTileSource>(FileTileSource::Parameters {})
+    };
+    auto use_upload_thread = false;
+    auto use_virtual_texture = false;
+    auto layer_roots = std::vector<std::string_view> {};
+    auto viewport_count = 1;
+    auto link_viewports = false;
+    auto use_tile_cache = true;
+    auto generate_lods = false;
+    auto persist_lods = false;
+    auto export_region = std::optional<Box2> {};
+    auto export_lod = 0u;
+    auto export_path = std::filesystem::path {"export.png"};
+
+    for (auto i = 1; i < argc; ++i) {
+        const auto arg = std::string_view {argv[i]};
+        if (arg == "--upload-thread") {
+            use_upload_thread = true;
+            continue;
+        }
+        if (arg == "--virtual-texture") {
+            use_virtual_texture = true;
+            continue;
+        }
+        if (arg == "--layer" && i + 1 < argc) {
+            layer_roots.emplace_back(argv[++i]);
+            continue;
+        }
+        if (arg == "--viewports" && i + 1 < argc) {
+            const auto value = std::string_view {argv[++i]};
+            std::from_chars(value.data(), value.data() + value.size(), viewport_count);
+            viewport_count = std::max(viewport_count, 1);
+            continue;
+        }
+        if (arg == "--link-viewports") {
+            link_viewports = true;
+            continue;
+        }
+        if (arg == "--no-tile-cache") {
+            use_tile_cache = false;
+            continue;
+        }
+        if (arg == "--generate-lods" || arg == "--persist-lods") {
+            generate_lods = true;
+            persist_lods = persist_lods || arg == "--persist-lods";
+            continue;
+        }
+        if (arg == "--export" && i + 1 < argc) {
+            export_region = parseRegion(argv[++i]);
+            if (!export_region) {
+                std::println("Expected the export region as x,y,width,height");
+                return 1;
+            }
+            continue;
+        }
+        if (arg == "--export-lod" && i + 1 < argc) {
+            const auto value = std::string_view {argv[++i]};
+            std::from_chars(value.data(), value.data() + value.size(), export_lod);
+            continue;
+        }
+        if (arg == "--export-to" && i + 1 < argc) {
+            export_path = argv[++i];
+            continue;
+        }
+#ifdef TILE_STREAMING_HAS_HTTP
+        if (auto params = HttpTileSource::FromUrl(arg)) {
+            source = std::make_shared<HttpTileSource>(params.value());
+            continue;
+        }
+#endif
+        std::println("Unsupported tile source '{}'", arg);
+    }
+
+    // All layers stream through one pipeline whose readers read local
+    // files, so the base pyramid has to be local too.
+    const auto local_source = std::dynamic_pointer_cast<FileTileSource>(source) != nullptr;
+    if (!layer_roots.empty() && !local_source) {
+        std::println("Layers can only be drawn over a local pyramid");
+        return 1;
+    }
+
+    // Generated tiles are saved where the source locates them, which is
+    // only a file for a local pyramid.
+    if (persist_lods && !local_source) {
+        std::println("Generated tiles are only saved next to a local pyramid");
+        persist_lods = false;
+    }
+
+    // Linked shader programs are reused across launches.
+    ProgramCache::Get().Enable(".cache/shaders");
+
+    // Decoded tiles are kept on disk as raw pixels, so that later launches
+    // map them instead of decoding the pyramid again.
+    const auto tile_cache = use_tile_cache ? TranscodeCache::Create() : nullptr;
+    auto pipeline_config = LoadPipeline<Image>::Config {
+        .make_reader = [source] { return source->CreateReader(); }
     };
+    if (tile_cache) TranscodeCache::Attach(tile_cache, pipeline_config);
+
+    const auto loader = ImageLoader::Create();
+    const auto generator = generate_lods ? std::make_shared<PyramidGenerator>(
+        source,
+        loader,
+        PyramidManifest::Geometry {
+            .width = static_cast<int>(texture_dims.width),
+            .height = static_cast<int>(texture_dims.height),
+            .tile_size = static_cast<int>(tile_size),
+            .lods = lods
+        },
+        PyramidGenerator::Config {.persist = persist_lods}
+    ) : nullptr;
+
+    // Layers stream through a pipeline of their own, so this manager and
+    // its workers only exist without layers, or to export.
+    auto tile_manager = std::unique_ptr<TileManager> {};
+    if (layer_roots.empty() || export_region) {
+        tile_manager = std::make_unique<TileManager>(
+            texture_dims,
+            window_dims,
+            tile_size,
+            lods,
+            source,
+            std::make_shared<LoadPipeline<Image>>(loader, pipeline_config),
+            loader
+        );
+        if (generator) tile_manager->EnableGeneration(generator);
+    }
+
+    if (export_region) {
+        // The window only provides a context; nothing is drawn to it.
+        auto window = Window {1, 1, "Tile Streaming", false};
+        auto exporter = RegionExporter {tile_manager.get(), {.region = export_region.value(), .lod = export_lod}};
+        if (auto result = exporter.Export(export_path); !result) {
+            std::println("Export failed: {}", result.error());
+            return 1;
+        }
+        std::println(
+            "Exported {}x{} pixels to {} in {} ms",
+            exporter.Width(),
+            exporter.Height(),
+            export_path.string(),
+            startup.GetMilliseconds()
+        );
+        return 0;
+    }
+
+    // The coarsest LOD loads on every core while the window and context are
+    // created, so the first frame already shows the whole image.
+    const auto preload = Timer {};
+    if (tile_manager) tile_manager->StartPreload();
 
     auto window = Window {
         static_cast<int>(window_dims.width),
@@ -37,6 +232,20 @@ auto main() -> int {
         "Tile Streaming"
     };
 
+    auto textures = std::unique_ptr<TileTextures> {};
+    if (tile_manager) textures = std::make_unique<TileTextures>(tile_manager.get());
+
+    // Declared after the window so that its context is destroyed first.
+    auto uploader = std::unique_ptr<UploadThread> {};
+    if (use_upload_thread && textures) {
+        if (auto context = window.CreateSharedContext()) {
+            uploader = std::make_unique<UploadThread>(context);
+            textures->SetUploadThread(uploader.get());
+        } else {
+            std::println("Failed to create a shared context, uploading on the render thread");
+        }
+    }
+
     // Match the camera's world-space width to the full image width so that
     // one world unit corresponds to one texel at LOD 0. This keeps zoom and
     // LOD calculations intuitive: at zoom = 1 the entire image fits exactly
@@ -44,41 +253,190 @@ auto main() -> int {
     const auto camera_width = texture_dims.width;
 
     const auto camera_height = camera_width / window_dims.AspectRatio();
+    // Only render while the camera moves or tiles are streaming in; an idle
+    // view blocks on input instead of spinning a core and the GPU.
+    window.SetRenderMode(RenderMode::OnDemand);
+
     auto camera = OrthographicCamera {0.0f, camera_width, camera_height, 0.0f, -1.0f, 1.0f};
     auto controls = ZoomPanCamera {&camera};
 
-    const auto geometry = PlaneGeometry {{
-        .width = 1024.0f,
-        .height = 1024.0f,
-        .width_segments = 1,
-        .height_segments = 1
-    }};
+    auto renderer = TileRenderer {tile_size};
+
+    // Created after the preload, which owns the manager until it finishes.
+    auto virtual_texture = std::unique_ptr<VirtualTexture> {};
+    if (tile_manager) {
+        const auto preloaded = tile_manager->FinishPreload();
+        if (use_virtual_texture) {
+            virtual_texture = VirtualTexture::Create(tile_manager.get(), window_dims);
+            if (!virtual_texture) std::println("Drawing tiles instead");
+        }
+        if (virtual_texture) {
+            virtual_texture->Update(UploadBudget::Unlimited());
+        } else {
+            textures->Update(UploadBudget::Unlimited());
+        }
+        std::println(
+            "Preloaded {} tiles in {} ms, {} from the tile cache",
+            preloaded,
+            preload.GetMilliseconds(),
+            tile_cache ? tile_cache->GetStats().hits : 0
+        );
+    }
+
+    // Reports time to first frame, and to the first frame with nothing left
+    // to stream in.
+    auto report_startup = [&startup, first = true, sharp = false](bool pending) mutable {
+        if (first) {
+            std::println("First frame after {} ms", startup.GetMilliseconds());
+            first = false;
+        }
+        if (!sharp && !pending) {
+            std::println("First sharp frame after {} ms", startup.GetMilliseconds());
+            sharp = true;
+        }
+    };
+
+    // Layers stream through their own shared pipeline; the base image is
+    // the first of them.
+    auto layers = std::unique_ptr<LayerStack> {};
+    if (!layer_roots.empty()) {
+        auto config = LayerStack::Config {
+            .image_dims = texture_dims,
+            .window_dims = window_dims,
+            .tile_size = tile_size,
+            .lods = lods
+        };
+        if (tile_cache) TranscodeCache::Attach(tile_cache, config.pipeline);
+        layers = std::make_unique<LayerStack>(config);
+        auto& base = layers->Add("Base", source);
+        if (generator) base.tiles.EnableGeneration(generator);
+        for (const auto root : layer_roots) {
+            layers->Add(
+                std::string {root},
+                std::make_shared<FileTileSource>(FileTileSource::Parameters {.root = root}),
+                {.opacity = 0.5f}
+            );
+        }
+    }
+
+    // Views beyond the first replace the single camera with one column of
+    // the window each.
+    auto viewports = std::vector<std::unique_ptr<Viewport>> {};
+    if (viewport_count > 1 && !layers && !virtual_texture) {
+        const auto column = window_dims.width / static_cast<float>(viewport_count);
+        for (auto i = 0; i < viewport_count; ++i) {
+            const auto left = column * static_cast<float>(i);
+            viewports.emplace_back(std::make_unique<Viewport>(
+                Box2 {{left, 0.0f}, {left + column, window_dims.height}},
+                texture_dims
+            ));
+        }
+    }
+    auto views = std::vector<TileManager::View> {};
 
-    auto tile_shader = Shaders {{
-        {ShaderType::kVertexShader, _SHADER_tile_vert},
-        {ShaderType::kFragmentShader, _SHADER_tile_frag}
-    }};
+    auto governor = FrameGovernor {};
 
     window.Start([&]([[maybe_unused]] const double _){
+        governor.BeginFrame();
+
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         controls.Update();
-        tile_manager.Update(camera);
-        tile_manager.Debug(camera);
-
-        tile_shader.Use();
-        tile_shader.SetUniform("u_Projection", camera.projection);
-
-        auto tiles = tile_manager.GetVisibleTiles();
-        for (auto& tile : tiles) {
-            if (tile->state == TileState::Loaded) {
-                tile->texture.Bind();
-                tile_shader.SetUniform("u_ModelView", camera.View() * tile->Transform());
-                geometry.Draw(tile_shader);
+
+        if (layers) {
+            layers->SetZoomVelocity(controls.ZoomVelocity());
+            layers->Update(camera, governor.Budget());
+            layers->Debug();
+            renderer.Debug();
+            governor.Debug();
+            layers->Draw(camera, renderer);
+            report_startup(layers->HasPendingWork());
+
+            if (controls.IsMoving() || layers->HasPendingWork()) {
+                window.RequestRedraw();
+            }
+
+            governor.EndFrame();
+            return;
+        }
+
+        if (!viewports.empty()) {
+            auto moving = false;
+            views.clear();
+            for (const auto& viewport : viewports) {
+                viewport->Update();
+                moving = moving || viewport->IsMoving();
+            }
+            if (link_viewports) Viewport::Link(viewports);
+            for (const auto& viewport : viewports) views.emplace_back(viewport->GetView());
+
+            tile_manager->Update(views);
+            textures->Update(governor.Budget());
+
+            ImGui::Begin("Viewports");
+            ImGui::Checkbox("Link", &link_viewports);
+            ImGui::End();
+            renderer.Debug();
+            governor.Debug();
+
+            const auto scale = window.FramebufferScale();
+            renderer.BeginFrame();
+            for (const auto& viewport : viewports) {
+                auto& render_list = viewport->RenderList();
+                tile_manager->BuildRenderList(viewport->GetView(), render_list);
+                viewport->Bind(window_dims, scale);
+                renderer.Draw(viewport->Camera(), render_list, *textures);
+            }
+            renderer.EndFrame();
+            glViewport(
+                0,
+                0,
+                static_cast<GLsizei>(window_dims.width * scale),
+                static_cast<GLsizei>(window_dims.height * scale)
+            );
+            report_startup(tile_manager->HasPendingWork() || textures->HasPendingWork());
+
+            if (moving || tile_manager->HasPendingWork() || textures->HasPendingWork()) {
+                window.RequestRedraw();
+            }
+
+            governor.EndFrame();
+            return;
+        }
+
+        if (virtual_texture) {
+            virtual_texture->RenderFeedback(camera);
+            virtual_texture->Update(governor.Budget());
+            virtual_texture->Debug();
+            governor.Debug();
+            virtual_texture->Draw(camera);
+            report_startup(virtual_texture->HasPendingWork());
+
+            if (controls.IsMoving() || virtual_texture->HasPendingWork()) {
+                window.RequestRedraw();
             }
+
+            governor.EndFrame();
+            return;
+        }
+
+        tile_manager->SetZoomVelocity(controls.ZoomVelocity());
+        tile_manager->Update(camera);
+        textures->Update(governor.Budget());
+        textures->Debug(camera);
+        renderer.Debug();
+        governor.Debug();
+
+        renderer.Draw(camera, tile_manager->GetRenderList(), *textures);
+        report_startup(tile_manager->HasPendingWork() || textures->HasPendingWork());
+
+        if (controls.IsMoving() || tile_manager->HasPendingWork() || textures->HasPendingWork()) {
+            window.RequestRedraw();
         }
+
+        governor.EndFrame();
     });
 
     return 0;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "region_exporter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <print>
+#include <thread>
+
+#include "loaders/png_writer.h"
+
+// Output is RGB; the tile shader's alpha carries nothing worth keeping.
+static constexpr int kChannels {3};
+
+// Rounds in which nothing was loading and the chunk still missed tiles,
+// after which it is drawn without them instead of retrying forever.
+static constexpr int kMaxIdleRounds {3};
+
+// How long a chunk may wait without one more of its tiles settling before
+// it is drawn without the rest, for tiles that keep being retried.
+static constexpr auto kStallTimeout = std::chrono::seconds {10};
+
+RegionExporter::RegionExporter(TileManager* tiles, const Config& config) :
+    tiles_(tiles),
+    textures_(tiles),
+    renderer_(tiles->TileSize()),
+    config_(config)
+{
+    config_.lod = std::min(config_.lod, tiles_->LodCount() - 1);
+    const auto scale = static_cast<float>(1u << config_.lod);
+    const auto size = config_.region.max - config_.region.min;
+    width_ = std::max(1, static_cast<int>(std::ceil(size.x / scale)));
+    height_ = std::max(1, static_cast<int>(std::ceil(size.y / scale)));
+
+    auto max_size = 0;
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &max_size);
+    config_.chunk_width = std::clamp(config_.chunk_width, 1, std::min(max_size, width_));
+    config_.band_height = std::clamp(config_.band_height, 1, std::min(max_size, height_));
+
+    glGenRenderbuffers(1, &color_);
+    glBindRenderbuffer(GL_RENDERBUFFER, color_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, config_.chunk_width, config_.band_height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    band_.resize(static_cast<std::size_t>(width_) * config_.band_height * kChannels);
+    pixels_.resize(static_cast<std::size_t>(config_.chunk_width) * config_.band_height * kChannels);
+}
+
+auto RegionExporter::Export(const fs::path& path) -> std::expected<void, std::string> {
+    auto writer = PngWriter::Open(
+        path,
+        static_cast<std::uint32_t>(width_),
+        static_cast<std::uint32_t>(height_),
+        kChannels
+    );
+    if (!writer) return std::unexpected(writer.error());
+
+    auto chunk = ChunkAt(0);
+    for (auto index = std::size_t {1}; chunk; ++index) {
+        const auto next = ChunkAt(index);
+        Prepare(chunk.value(), next);
+        Render(chunk.value());
+
+        if (chunk->x + chunk->width == width_) {
+            writer->WriteRows(std::span {band_}.first(writer->RowBytes() * chunk->height));
+        }
+
+        const auto resident = textures_.ResidentBytes();
+        if (resident > config_.texture_budget) textures_.Evict(resident - config_.texture_budget);
+        chunk = next;
+    }
+
+    return writer->Finish();
+}
+
+auto RegionExporter::ChunkAt(std::size_t index) const -> std::optional<Chunk> {
+    const auto columns = static_cast<std::size_t>((width_ + config_.chunk_width - 1) / config_.chunk_width);
+    const auto x = static_cast<int>(index % columns) * config_.chunk_width;
+    const auto y = static_cast<int>(index / columns) * config_.band_height;
+    if (y >= height_) return std::nullopt;
+    return Chunk {
+        .x = x,
+        .y = y,
+        .width = std::min(config_.chunk_width, width_ - x),
+        .height = std::min(config_.band_height, height_ - y)
+    };
+}
+
+auto RegionExporter::WorldBounds(const Chunk& chunk) const -> Box2 {
+    const auto scale = static_cast<float>(1u << config_.lod);
+    const auto min = config_.region.min + glm::vec2 {static_cast<float>(chunk.x), static_cast<float>(chunk.y)} * scale;
+    const auto size = glm::vec2 {static_cast<float>(chunk.width), static_cast<float>(chunk.height)} * scale;
+    return {.min = min, .max = min + size};
+}
+
+auto RegionExporter::AppendTiles(const Chunk& chunk, std::vector<TileId>& ids) const -> void {
+    const auto& level = tiles_->GetLevel(config_.lod);
+    const auto extent = tiles_->TileSize() * static_cast<float>(1u << config_.lod);
+    const auto bounds = WorldBounds(chunk);
+
+    const auto first_x = std::max(0, static_cast<int>(std::floor(bounds.min.x / extent)));
+    const auto first_y = std::max(0, static_cast<int>(std::floor(bounds.min.y / extent)));
+    const auto last_x = std::min(level.TilesX(), static_cast<int>(std::ceil(bounds.max.x / extent)));
+    const auto last_y = std::min(level.TilesY(), static_cast<int>(std::ceil(bounds.max.y / extent)));
+    for (auto y = first_y; y < last_y; ++y) {
+        for (auto x = first_x; x < last_x; ++x) {
+            ids.emplace_back(TileId {config_.lod, x, y});
+        }
+    }
+}
+
+auto RegionExporter::Prepare(const Chunk& chunk, const std::optional<Chunk>& next) -> void {
+    auto wanted = std::vector<TileId> {};
+    AppendTiles(chunk, wanted);
+    const auto needed = wanted.size();
+    if (next) AppendTiles(next.value(), wanted);
+
+    const auto& level = tiles_->GetLevel(config_.lod);
+    // Tiles that failed to load are drawn as holes, like missing ones.
+    const auto settled = [&] {
+        return std::ranges::count_if(std::span {wanted}.first(needed), [&](const TileId& id) {
+            const auto state = level.state[level.Index(id)];
+            return state == TileState::Loaded || state == TileState::Missing || state == TileState::Error;
+        });
+    };
+
+    auto progress = std::chrono::steady_clock::now();
+    auto last_settled = std::ptrdiff_t {-1};
+    for (auto idle_rounds = 0;;) {
+        const auto idle = !tiles_->HasPendingWork() && !textures_.HasPendingWork();
+
+        // Requests the current chunk's tiles ahead of the next one's.
+        tiles_->Request(wanted);
+        textures_.Update(UploadBudget::Unlimited());
+        const auto count = settled();
+        if (count == static_cast<std::ptrdiff_t>(needed)) return;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (count != last_settled) {
+            last_settled = count;
+            progress = now;
+        }
+
+        if ((idle && ++idle_rounds > kMaxIdleRounds) || now - progress > kStallTimeout) {
+            std::println("Exporting rows {} to {} with tiles missing", chunk.y, chunk.y + chunk.height);
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds {1});
+    }
+}
+
+auto RegionExporter::Render(const Chunk& chunk) -> void {
+    const auto bounds = WorldBounds(chunk);
+    const auto camera = OrthographicCamera {bounds.min.x, bounds.max.x, bounds.max.y, bounds.min.y, -1.0f, 1.0f};
+    tiles_->BuildRenderList({.camera = &camera, .width = static_cast<float>(chunk.width)}, render_list_);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glViewport(0, 0, chunk.width, chunk.height);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    renderer_.Draw(camera, render_list_, textures_);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, chunk.width, chunk.height, GL_RGB, GL_UNSIGNED_BYTE, pixels_.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // GL counts rows from the bottom.
+    const auto chunk_row = static_cast<std::size_t>(chunk.width) * kChannels;
+    const auto band_row = static_cast<std::size_t>(width_) * kChannels;
+    for (auto row = 0; row < chunk.height; ++row) {
+        std::copy_n(
+            pixels_.data() + static_cast<std::size_t>(chunk.height - 1 - row) * chunk_row,
+            chunk_row,
+            band_.data() + row * band_row + static_cast<std::size_t>(chunk.x) * kChannels
+        );
+    }
+}
+
+RegionExporter::~RegionExporter() {
+    // The textures go with the exporter, so tiles that use them, or wait
+    // for an upload, are handed back to the manager unloaded.
+    for (auto lod = 0u; lod < tiles_->LodCount(); ++lod) {
+        const auto& level = tiles_->GetLevel(lod);
+        for (auto i = std::size_t {0}; i < level.Size(); ++i) {
+            const auto uploaded = level.state[i] == TileState::Loaded && level.texture[i] != kNoTexture;
+            if (uploaded || level.state[i] == TileState::Decoded) tiles_->Evict(level.Id(i));
+        }
+    }
+
+    glDeleteFramebuffers(1, &framebuffer_);
+    glDeleteRenderbuffers(1, &color_);
+}
@@ -0,0 +1,103 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "tile_manager.h"
+#include "tile_renderer.h"
+#include "tile_textures.h"
+#include "types.h"
+
+namespace fs = std::filesystem;
+
+// Renders a region of the image at one LOD into a PNG of any size. The
+// output is drawn through the tile shader into an offscreen framebuffer one
+// chunk at a time, left to right along bands of rows, and each finished band
+// is written out before the next one starts. Only the tiles of the current
+// chunk and the next one are requested, and textures past the budget are
+// evicted. Memory does not grow with the output's height, but the band
+// holds band_height full output rows, so it grows with its width.
+//
+// Needs a current GL context. Uses the manager exclusively while it exists,
+// and unloads the tiles it uploaded when it goes.
+class RegionExporter {
+public:
+    struct Config {
+        // In LOD 0 pixels, which is also world units.
+        Box2 region;
+
+        // Every output pixel covers 2^lod source pixels on each side.
+        unsigned lod {0};
+
+        int band_height {256};
+        int chunk_width {4096};
+
+        std::size_t texture_budget {256 * 1024 * 1024};
+    };
+
+    RegionExporter(TileManager* tiles, const Config& config);
+
+    RegionExporter(const RegionExporter&) = delete;
+    RegionExporter& operator=(const RegionExporter&) = delete;
+
+    // Output size in pixels.
+    [[nodiscard]] auto Width() const -> int {
+        return width_;
+    }
+
+    [[nodiscard]] auto Height() const -> int {
+        return height_;
+    }
+
+    [[nodiscard]] auto Export(const fs::path& path) -> std::expected<void, std::string>;
+
+    ~RegionExporter();
+
+private:
+    // A rectangle of the output, in output pixels.
+    struct Chunk {
+        int x {0};
+        int y {0};
+        int width {0};
+        int height {0};
+    };
+
+    TileManager* tiles_ {nullptr};
+    TileTextures textures_;
+    TileRenderer renderer_;
+
+    Config config_;
+
+    int width_ {0};
+    int height_ {0};
+
+    GLuint framebuffer_ {0};
+    GLuint color_ {0};
+
+    // Rows of the band being rendered, top to bottom, and one chunk as
+    // read back from the framebuffer, bottom to top.
+    std::vector<unsigned char> band_;
+    std::vector<unsigned char> pixels_;
+
+    std::vector<RenderTile> render_list_;
+
+    [[nodiscard]] auto ChunkAt(std::size_t index) const -> std::optional<Chunk>;
+
+    [[nodiscard]] auto WorldBounds(const Chunk& chunk) const -> Box2;
+
+    auto AppendTiles(const Chunk& chunk, std::vector<TileId>& ids) const -> void;
+
+    // Streams in the chunk's tiles, and the next chunk's behind them.
+    auto Prepare(const Chunk& chunk, const std::optional<Chunk>& next) -> void;
+
+    auto Render(const Chunk& chunk) -> void;
+};
@@ -0,0 +1,259 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "region_reader.h"
+
+#include <cmath>
+#include <cstring>
+#include <format>
+
+static auto packKey(const TileId& id) -> std::uint64_t {
+    return (static_cast<std::uint64_t>(id.lod) << 48) |
+           (static_cast<std::uint64_t>(id.y) << 24) |
+           static_cast<std::uint64_t>(id.x);
+}
+
+RegionReader::RegionReader(
+    std::shared_ptr<TileSource> source,
+    std::shared_ptr<Loader<Image>> decoder,
+    std::shared_ptr<TileCache> cache,
+    const PyramidManifest::Geometry& geometry,
+    const Config& config
+) :
+    source_(std::move(source)),
+    decoder_(std::move(decoder)),
+    cache_(std::move(cache)),
+    manifest_(source_->Manifest()),
+    geometry_(geometry),
+    tasks_(config.queue_capacity)
+{
+    for (auto i = 0u; i < config.workers; ++i) {
+        workers_.emplace_back([this] {
+            auto reader = source_->CreateBlockingReader();
+            while (auto task = tasks_.Pop()) task.value()(reader);
+        });
+    }
+}
+
+auto RegionReader::GetFormat() -> std::expected<Format, std::string> {
+    {
+        auto lock = std::scoped_lock {mutex_};
+        if (format_) return format_.value();
+    }
+
+    // The coarsest level has the fewest tiles to skip past.
+    auto reader = std::unique_ptr<FileReader> {};
+    const auto lod = static_cast<unsigned>(geometry_.lods - 1);
+    for (auto y = 0; y < TilesY(lod); ++y) {
+        for (auto x = 0; x < TilesX(lod); ++x) {
+            auto tile = Load({lod, x, y}, reader);
+            if (!tile) return std::unexpected(tile.error());
+            if (tile.value() == nullptr) continue;
+
+            const auto format = Format {.depth = tile.value()->depth, .bit_depth = tile.value()->bit_depth};
+            auto lock = std::scoped_lock {mutex_};
+            format_ = format;
+            return format;
+        }
+    }
+    return std::unexpected(std::string {"The pyramid has no tiles"});
+}
+
+auto RegionReader::ReadRegion(
+    unsigned lod,
+    const Rect& rect,
+    std::span<unsigned char> pixels,
+    std::size_t stride
+) -> Result {
+    const auto request = Request {.lod = lod, .rect = rect, .pixels = pixels, .stride = stride};
+    Prefetch(CoveringTiles(lod, rect));
+    auto reader = std::unique_ptr<FileReader> {};
+    return Read(request, reader);
+}
+
+auto RegionReader::ReadRegions(std::span<const Request> requests) -> std::vector<Result> {
+    for (const auto& request : requests) {
+        Prefetch(CoveringTiles(request.lod, request.rect));
+    }
+
+    auto reader = std::unique_ptr<FileReader> {};
+    auto results = std::vector<Result> {};
+    results.reserve(requests.size());
+    for (const auto& request : requests) {
+        results.emplace_back(Read(request, reader));
+    }
+    return results;
+}
+
+auto RegionReader::ReadRegionAsync(const Request& request) -> std::future<Result> {
+    auto promise = std::make_shared<std::promise<Result>>();
+    auto future = promise->get_future();
+
+    // Queued ahead of the copy, so that other workers are loading the
+    // tiles by the time a worker starts on it.
+    Prefetch(CoveringTiles(request.lod, request.rect));
+    const auto queued = tasks_.Push([this, request, promise](std::unique_ptr<FileReader>& reader) {
+        try {
+            promise->set_value(Read(request, reader));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    });
+    if (!queued) promise->set_value(std::unexpected(std::string {"The region reader is shutting down"}));
+    return future;
+}
+
+auto RegionReader::Read(const Request& request, std::unique_ptr<FileReader>& reader) -> Result {
+    const auto& rect = request.rect;
+    if (request.lod >= static_cast<unsigned>(geometry_.lods)) {
+        return std::unexpected(std::format("LOD {} is past the pyramid's {} levels", request.lod, geometry_.lods));
+    }
+    if (rect.width <= 0 || rect.height <= 0) {
+        return std::unexpected(std::format("Cannot read a {}x{} region", rect.width, rect.height));
+    }
+
+    const auto format = GetFormat();
+    if (!format) return std::unexpected(format.error());
+
+    const auto pixel_bytes = format->BytesPerPixel();
+    const auto row_bytes = static_cast<std::size_t>(rect.width) * pixel_bytes;
+    const auto stride = request.stride == 0 ? row_bytes : request.stride;
+    const auto needed = stride * static_cast<std::size_t>(rect.height - 1) + row_bytes;
+    if (stride < row_bytes || request.pixels.size() < needed) {
+        return std::unexpected(std::format("A {}x{} region needs {} bytes, the buffer has {}", rect.width, rect.height, needed, request.pixels.size()));
+    }
+
+    for (auto row = 0; row < rect.height; ++row) {
+        std::memset(request.pixels.data() + static_cast<std::size_t>(row) * stride, 0, row_bytes);
+    }
+
+    const auto tile_size = geometry_.tile_size;
+    for (const auto& id : CoveringTiles(request.lod, rect)) {
+        const auto tile = Load(id, reader);
+        if (!tile) return std::unexpected(tile.error());
+        const auto& image = tile.value();
+        if (image == nullptr) continue;
+        if (image->depth != format->depth || image->bit_depth != format->bit_depth) {
+            return std::unexpected(std::format("Tile {} differs in format from the rest of the pyramid", id));
+        }
+
+        const auto tile_x = id.x * tile_size;
+        const auto tile_y = id.y * tile_size;
+        const auto left = std::max(rect.x, tile_x);
+        const auto right = std::min(rect.x + rect.width, tile_x + static_cast<int>(image->width));
+        const auto top = std::max(rect.y, tile_y);
+        const auto bottom = std::min(rect.y + rect.height, tile_y + static_cast<int>(image->height));
+        if (left >= right) continue;
+
+        const auto bytes = static_cast<std::size_t>(right - left) * pixel_bytes;
+        for (auto y = top; y < bottom; ++y) {
+            std::memcpy(
+                request.pixels.data() + static_cast<std::size_t>(y - rect.y) * stride +
+                    static_cast<std::size_t>(left - rect.x) * pixel_bytes,
+                image->Data() + static_cast<std::size_t>(y - tile_y) * image->RowBytes() +
+                    static_cast<std::size_t>(left - tile_x) * pixel_bytes,
+                bytes
+            );
+        }
+    }
+    return {};
+}
+
+auto RegionReader::CoveringTiles(unsigned lod, const Rect& rect) const -> std::vector<TileId> {
+    auto ids = std::vector<TileId> {};
+    if (lod >= static_cast<unsigned>(geometry_.lods) || rect.width <= 0 || rect.height <= 0) return ids;
+
+    const auto tile_size = geometry_.tile_size;
+    const auto first_x = std::max(0, rect.x / tile_size);
+    const auto first_y = std::max(0, rect.y / tile_size);
+    const auto last_x = std::min(TilesX(lod), (rect.x + rect.width + tile_size - 1) / tile_size);
+    const auto last_y = std::min(TilesY(lod), (rect.y + rect.height + tile_size - 1) / tile_size);
+    for (auto y = first_y; y < last_y; ++y) {
+        for (auto x = first_x; x < last_x; ++x) {
+            ids.emplace_back(TileId {lod, x, y});
+        }
+    }
+    return ids;
+}
+
+auto RegionReader::Prefetch(std::span<const TileId> ids) -> void {
+    for (const auto& id : ids) {
+        if (manifest_ != nullptr && !manifest_->Exists(id)) continue;
+        auto task = Task {[this, id](std::unique_ptr<FileReader>& reader) {
+            // Whoever needs the tile gets the exception from its own Load().
+            try {
+                (void)Load(id, reader);
+            } catch (...) {}
+        }};
+        if (!tasks_.TryPush(std::move(task))) return;
+    }
+}
+
+auto RegionReader::Load(const TileId& id, std::unique_ptr<FileReader>& reader) -> LoaderResult<Image> {
+    if (manifest_ != nullptr && !manifest_->Exists(id)) return nullptr;
+
+    // Duplicates share their group's file, and so its cache entry.
+    const auto group = manifest_ != nullptr ? manifest_->Group(id) : std::nullopt;
+    const auto content = group ? manifest_->GroupSource(group.value()) : id;
+    const auto path = source_->Locate(content);
+    const auto key = packKey(content);
+
+    auto promise = std::promise<LoaderResult<Image>> {};
+    {
+        auto lock = std::unique_lock {mutex_};
+        if (auto image = cache_->Find(path)) return image;
+        if (const auto it = loading_.find(key); it != loading_.end()) {
+            // Whoever loads it waits on nothing, so this cannot cycle.
+            const auto pending = it->second;
+            lock.unlock();
+            return pending.get();
+        }
+        loading_.emplace(key, promise.get_future().share());
+    }
+
+    const auto finish = [&] {
+        auto lock = std::scoped_lock {mutex_};
+        loading_.erase(key);
+    };
+
+    auto result = LoaderResult<Image> {};
+    try {
+        result = [&]() -> LoaderResult<Image> {
+            if (auto valid = decoder_->Validate(path); !valid) return std::unexpected(valid.error());
+            if (reader == nullptr) reader = source_->CreateBlockingReader();
+            auto data = reader->ReadBatch(std::span {&path, 1});
+            if (!data.front()) {
+                // Without a manifest, an absent file is the only sign of a missing tile.
+                if (manifest_ == nullptr && IsNotFound(data.front().error())) return nullptr;
+                return std::unexpected(data.front().error());
+            }
+            return decoder_->Decode(data.front().value(), path);
+        }();
+        if (result && result.value() != nullptr) cache_->Insert(path, result.value());
+    } catch (...) {
+        // Threads waiting on the load rethrow rather than hang, and the
+        // next one to need the tile tries again.
+        finish();
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    finish();
+    promise.set_value(result);
+    return result;
+}
+
+auto RegionReader::TilesX(unsigned lod) const -> int {
+    const auto size = static_cast<float>(geometry_.tile_size * (1 << lod));
+    return static_cast<int>(std::ceil(static_cast<float>(geometry_.width) / size));
+}
+
+auto RegionReader::TilesY(unsigned lod) const -> int {
+    const auto size = static_cast<float>(geometry_.tile_size * (1 << lod));
+    return static_cast<int>(std::ceil(static_cast<float>(geometry_.height) / size));
+}
+
+RegionReader::~RegionReader() {
+    tasks_.Close();
+    workers_.clear();
+}
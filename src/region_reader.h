@@ -0,0 +1,142 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "core/bounded_queue.h"
+#include "core/image.h"
+#include "loaders/loader.h"
+#include "loaders/tile_cache.h"
+#include "sources/pyramid_manifest.h"
+#include "sources/tile_source.h"
+#include "tile.h"
+
+// Copies the pixels of any rectangle of the pyramid into memory, for code
+// that analyses the image rather than drawing it. Needs no GL context.
+//
+// The tiles covering a rectangle are queued to workers that read and decode
+// them in parallel, while the calling thread takes the first it can: a tile
+// is only ever loaded by one thread, and everyone else who needs it waits
+// for that load. Decoded tiles go through the shared cache, so a viewer
+// attached to the same cache and the reader decode each tile once between
+// them. All methods can be called from any thread.
+class RegionReader {
+public:
+    struct Config {
+        unsigned workers {std::max(1u, std::thread::hardware_concurrency() / 2)};
+        std::size_t queue_capacity {256};
+    };
+
+    // In pixels of the LOD being read.
+    struct Rect {
+        int x {0};
+        int y {0};
+        int width {0};
+        int height {0};
+    };
+
+    struct Format {
+        unsigned depth {0};
+        unsigned bit_depth {0};
+
+        [[nodiscard]] auto BytesPerPixel() const -> std::size_t {
+            return static_cast<std::size_t>(depth) * (bit_depth / 8);
+        }
+    };
+
+    // Rows of `pixels` are `stride` bytes apart, or tightly packed when it
+    // is 0. Pixels outside the image or in tiles the pyramid lacks are 0.
+    struct Request {
+        unsigned lod {0};
+        Rect rect;
+        std::span<unsigned char> pixels;
+        std::size_t stride {0};
+    };
+
+    using Result = std::expected<void, std::string>;
+
+    RegionReader(
+        std::shared_ptr<TileSource> source,
+        std::shared_ptr<Loader<Image>> decoder,
+        std::shared_ptr<TileCache> cache,
+        const PyramidManifest::Geometry& geometry,
+        const Config& config
+    );
+
+    RegionReader(const RegionReader&) = delete;
+    RegionReader& operator=(const RegionReader&) = delete;
+
+    // Channels and bit depth of the pyramid's tiles, which size the
+    // buffers. Read from the first tile on the first call.
+    [[nodiscard]] auto GetFormat() -> std::expected<Format, std::string>;
+
+    [[nodiscard]] auto ReadRegion(
+        unsigned lod,
+        const Rect& rect,
+        std::span<unsigned char> pixels,
+        std::size_t stride = 0
+    ) -> Result;
+
+    // Queues the tiles of every request before copying any, so that tiles
+    // shared between requests are loaded once and in parallel.
+    [[nodiscard]] auto ReadRegions(std::span<const Request> requests) -> std::vector<Result>;
+
+    // Reads the region on a worker. Blocks only while the worker queue is
+    // full. The buffer must outlive the future.
+    [[nodiscard]] auto ReadRegionAsync(const Request& request) -> std::future<Result>;
+
+    ~RegionReader();
+
+private:
+    using Task = std::function<void(std::unique_ptr<FileReader>&)>;
+
+    std::shared_ptr<TileSource> source_;
+    std::shared_ptr<Loader<Image>> decoder_;
+    std::shared_ptr<TileCache> cache_;
+    const PyramidManifest* manifest_ {nullptr};
+    PyramidManifest::Geometry geometry_;
+
+    // Tiles being loaded, by tile.
+    std::mutex mutex_;
+    std::unordered_map<std::uint64_t, std::shared_future<LoaderResult<Image>>> loading_;
+    std::optional<Format> format_;
+
+    BoundedQueue<Task> tasks_;
+
+    // Declared last so that the workers are joined before what they use.
+    std::vector<std::jthread> workers_;
+
+    [[nodiscard]] auto Read(const Request& request, std::unique_ptr<FileReader>& reader) -> Result;
+
+    // Tiles of the LOD that overlap the rectangle, clipped to the image.
+    [[nodiscard]] auto CoveringTiles(unsigned lod, const Rect& rect) const -> std::vector<TileId>;
+
+    // Queues loads for workers, skipping tiles the pyramid lacks and giving
+    // up quietly when the queue is full.
+    auto Prefetch(std::span<const TileId> ids) -> void;
+
+    // The tile's pixels, or nullptr if the pyramid lacks it. Loads the tile
+    // on the calling thread, creating its reader on first use, unless
+    // another thread is loading it already. Exceptions from reading or
+    // decoding reach every thread waiting on the load.
+    auto Load(const TileId& id, std::unique_ptr<FileReader>& reader) -> LoaderResult<Image>;
+
+    [[nodiscard]] auto TilesX(unsigned lod) const -> int;
+
+    [[nodiscard]] auto TilesY(unsigned lod) const -> int;
+};
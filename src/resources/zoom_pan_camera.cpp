@@ -3,6 +3,8 @@
 
 #include "zoom_pan_camera.h"
 
+#include <cmath>
+
 #include <glm/gtc/matrix_transform.hpp>
 
 ZoomPanCamera::ZoomPanCamera(OrthographicCamera* camera) : camera_(camera)  {
@@ -12,6 +14,7 @@ ZoomPanCamera::ZoomPanCamera(OrthographicCamera* camera) : camera_(camera)  {
     mouse_event_listener_ = std::make_shared<EventListener>([this](Event* event) {
         if (auto e = event->As<MouseEvent>()) {
             if ((e->type == ButtonPressed || e->type == ButtonReleased) && e->button == Left) {
+                if (e->type == ButtonPressed && !InRegion(mouse_position_)) return;
                 is_panning_ = e->type == ButtonPressed;
                 if (!is_panning_) {
                     is_first_pan_ = true;
@@ -23,8 +26,8 @@ ZoomPanCamera::ZoomPanCamera(OrthographicCamera* camera) : camera_(camera)  {
                     pan_ = true;
                 }
             }
-            if (e->type == Scrolled) {
-                curr_scroll_ = e->scroll.y;
+            if (e->type == Scrolled && InRegion(e->position)) {
+                curr_scroll_ += e->scroll.y;
                 if (curr_scroll_ != 0.0f) zoom_ = true;
             }
         }
@@ -51,15 +54,18 @@ auto ZoomPanCamera::Pan() -> void {
     );
 }
 
-auto ZoomPanCamera::Zoom() -> void {
+auto ZoomPanCamera::Zoom() -> float {
     zoom_ = false;
 
-    auto zoom_factor = 1.0f - curr_scroll_ * 0.01f;
+    // Scroll arrives coalesced per frame, so apply the per-step factor once
+    // for every accumulated step rather than scaling it linearly.
+    auto zoom_factor = std::pow(1.0f - kZoomSpeed, curr_scroll_);
+    curr_scroll_ = 0.0f;
     zoom_factor_ *= zoom_factor;
 
     if (zoom_factor_ < 0.1f || zoom_factor_ > 5.0f) {
         zoom_factor_ = glm::clamp(zoom_factor_, 0.1f, 5.0f);
-        return;
+        return 0.0f;
     }
 
     auto x_offset = camera_->Width() / 2.0f;
@@ -68,11 +74,29 @@ auto ZoomPanCamera::Zoom() -> void {
     camera_->transform = glm::translate(camera_->transform, glm::vec3 {x_offset, y_offset, 0.0f});
     camera_->transform = glm::scale(camera_->transform, glm::vec3 {zoom_factor, zoom_factor, 1.0f});
     camera_->transform = glm::translate(camera_->transform, glm::vec3 {-x_offset, -y_offset, 0.0f});
+    return std::log2(zoom_factor);
 }
 
 auto ZoomPanCamera::Update() -> void {
-    if (zoom_) Zoom();
+    const auto now = Clock::now();
+    const auto seconds = std::chrono::duration<float> {now - last_update_}.count();
+    last_update_ = now;
+
+    is_moving_ = zoom_ || pan_;
+    const auto lods = zoom_ ? Zoom() : 0.0f;
     if (pan_) Pan();
+
+    if (seconds > 0.0f) {
+        const auto blend = 1.0f - std::exp(-seconds / kVelocitySmoothing);
+        zoom_velocity_ += (lods / seconds - zoom_velocity_) * blend;
+    }
+}
+
+auto ZoomPanCamera::SyncFrom(const ZoomPanCamera& other) -> void {
+    if (&other == this) return;
+    camera_->transform = other.camera_->transform;
+    zoom_factor_ = other.zoom_factor_;
+    zoom_velocity_ = other.zoom_velocity_;
 }
 
 ZoomPanCamera::~ZoomPanCamera() {
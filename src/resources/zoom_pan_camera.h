@@ -5,24 +5,55 @@
 
 #include "core/event_dispatcher.h"
 #include "core/orthographic_camera.h"
+#include "core/timer.h"
+#include "types.h"
 
 #include <memory>
+#include <optional>
 
 #include <glm/vec2.hpp>
 
 class ZoomPanCamera {
 public:
     static constexpr float kPanSpeed {6.0f};
+    static constexpr float kZoomSpeed {0.01f};
+
+    // Time constant, in seconds, of the smoothing applied to the zoom
+    // velocity, so that one wheel notch between idle frames reads as slow.
+    static constexpr float kVelocitySmoothing {0.1f};
 
     explicit ZoomPanCamera(OrthographicCamera* camera);
 
     auto Update() -> void;
 
+    // Only presses and scrolls inside the region, in window coordinates,
+    // move the camera. Without one the whole window does.
+    auto SetRegion(const Box2& region) -> void {
+        region_ = region;
+    }
+
+    [[nodiscard]] auto IsMoving() const -> bool {
+        return is_moving_;
+    }
+
+    // How fast the view moves through LODs, in levels per second. Positive
+    // while zooming out towards coarser levels, and decaying to 0 once the
+    // zoom stops.
+    [[nodiscard]] auto ZoomVelocity() const -> float {
+        return zoom_velocity_;
+    }
+
+    // Moves this camera to the other's view and takes on its zoom, so the
+    // zoom limits and velocity stay true for a camera that follows another.
+    auto SyncFrom(const ZoomPanCamera& other) -> void;
+
     ~ZoomPanCamera();
 
 private:
     OrthographicCamera* camera_;
 
+    std::optional<Box2> region_;
+
     std::shared_ptr<EventListener> mouse_event_listener_;
 
     glm::vec2 mouse_position_ {0.0f};
@@ -37,6 +68,17 @@ private:
     bool pan_ {false};
     bool zoom_ {true};
 
+    bool is_moving_ {false};
+
+    float zoom_velocity_ {0.0f};
+    Clock::time_point last_update_ {Clock::now()};
+
     auto Pan() -> void;
-    auto Zoom() -> void;
+
+    // Returns how many LODs the zoom moved the view, log2 of the scale.
+    auto Zoom() -> float;
+
+    [[nodiscard]] auto InRegion(const glm::vec2& position) const -> bool {
+        return !region_ || region_->Contains(position);
+    }
 };
\ No newline at end of file
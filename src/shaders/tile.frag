@@ -5,9 +5,35 @@
 layout (location = 0) out vec4 FragColor;
 
 in vec2 v_TexCoord;
+flat in vec4 v_Color;
+flat in int v_Solid;
 
 uniform sampler2D u_TextureMap;
 
+// Display mapping, applied here so that adjusting it never re-decodes or
+// re-uploads a tile. Values are normalized; 1.0 is 65535 for 16-bit tiles.
+uniform vec2 u_Window;
+uniform float u_Gamma;
+
+uniform sampler1D u_Lut;
+uniform int u_LutSize;
+
+uniform float u_Opacity;
+
 void main() {
-    FragColor = texture(u_TextureMap, v_TexCoord);
+    // Solid tiles have no texture but go through the same display mapping.
+    vec4 color = v_Solid != 0 ? v_Color : texture(u_TextureMap, v_TexCoord);
+
+    vec3 value = clamp((color.rgb - u_Window.x) / (u_Window.y - u_Window.x), 0.0, 1.0);
+    value = pow(value, vec3(1.0 / u_Gamma));
+
+    // The LUT maps the first channel, which is the sample of gray tiles.
+    if (u_LutSize > 0) {
+        float texel = (value.r * float(u_LutSize - 1) + 0.5) / float(u_LutSize);
+        value = texture(u_Lut, texel).rgb;
+    }
+
+    // Premultiplied, which every blend mode of TileRenderer expects.
+    float alpha = color.a * u_Opacity;
+    FragColor = vec4(value * alpha, alpha);
 }
\ No newline at end of file
@@ -5,12 +5,24 @@
 layout (location = 0) in vec3 a_Position;
 layout (location = 2) in vec2 a_TexCoord;
 
-uniform mat4 u_Projection;
-uniform mat4 u_ModelView;
+layout (std140) uniform Camera {
+    mat4 u_Projection;
+    mat4 u_View;
+};
+
+layout (std140) uniform Tile {
+    mat4 u_Model;
+    vec4 u_Color;
+    int u_Solid;
+};
 
 out vec2 v_TexCoord;
+flat out vec4 v_Color;
+flat out int v_Solid;
 
 void main() {
     v_TexCoord = a_TexCoord;
-    gl_Position = u_Projection * u_ModelView * vec4(a_Position, 1.0);
+    v_Color = u_Color;
+    v_Solid = u_Solid;
+    gl_Position = u_Projection * u_View * u_Model * vec4(a_Position, 1.0);
 }
\ No newline at end of file
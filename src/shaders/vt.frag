@@ -0,0 +1,37 @@
+#version 410 core
+#pragma debug(on)
+#pragma optimize(off)
+
+layout (location = 0) out vec4 FragColor;
+
+in vec2 v_World;
+
+// One mip level per LOD. Each texel is a virtual tile and holds the cache
+// slot of the finest resident tile covering it, that tile's LOD, and
+// whether anything covering it is resident at all.
+uniform usampler2D u_PageTable;
+uniform sampler2D u_Cache;
+
+uniform vec2 u_ImageSize;
+uniform vec2 u_CacheSlots;
+uniform float u_TileSize;
+uniform float u_LodBias;
+uniform int u_MaxLod;
+
+void main() {
+    vec2 world = clamp(v_World, vec2(0.0), u_ImageSize - 0.5);
+    vec2 footprint = max(abs(dFdx(v_World)), abs(dFdy(v_World)));
+    int lod = clamp(int(floor(log2(max(footprint.x, footprint.y)) + u_LodBias)), 0, u_MaxLod);
+
+    ivec2 page = ivec2(world / (u_TileSize * exp2(float(lod))));
+    uvec4 entry = texelFetch(u_PageTable, page, lod);
+    if (entry.a == 0u) discard;
+
+    // Position inside the resident tile, kept half a texel away from its
+    // edges so bilinear taps never reach a neighbouring slot.
+    vec2 local = fract(world / (u_TileSize * exp2(float(entry.b)))) * u_TileSize;
+    local = clamp(local, vec2(0.5), vec2(u_TileSize - 0.5));
+
+    vec2 uv = (vec2(entry.rg) * u_TileSize + local) / (u_CacheSlots * u_TileSize);
+    FragColor = textureLod(u_Cache, uv, 0.0);
+}
\ No newline at end of file
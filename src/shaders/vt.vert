@@ -0,0 +1,21 @@
+#version 410 core
+#pragma debug(on)
+#pragma optimize(off)
+
+layout (location = 0) in vec3 a_Position;
+
+layout (std140) uniform Camera {
+    mat4 u_Projection;
+    mat4 u_View;
+};
+
+uniform mat4 u_Model;
+
+// World units are LOD 0 texels.
+out vec2 v_World;
+
+void main() {
+    vec4 world = u_Model * vec4(a_Position, 1.0);
+    v_World = world.xy;
+    gl_Position = u_Projection * u_View * world;
+}
\ No newline at end of file
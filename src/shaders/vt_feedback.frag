@@ -0,0 +1,24 @@
+#version 410 core
+#pragma debug(on)
+#pragma optimize(off)
+
+layout (location = 0) out uvec4 Feedback;
+
+in vec2 v_World;
+
+uniform vec2 u_ImageSize;
+uniform float u_TileSize;
+uniform float u_LodBias;
+uniform int u_MaxLod;
+
+// Writes the tile this pixel samples as (x, y, lod, 1). The pass runs at a
+// fraction of the window size and u_LodBias compensates for the larger
+// pixels, so it picks the same LOD as the full-size pass.
+void main() {
+    vec2 world = clamp(v_World, vec2(0.0), u_ImageSize - 0.5);
+    vec2 footprint = max(abs(dFdx(v_World)), abs(dFdy(v_World)));
+    int lod = clamp(int(floor(log2(max(footprint.x, footprint.y)) + u_LodBias)), 0, u_MaxLod);
+
+    ivec2 page = ivec2(world / (u_TileSize * exp2(float(lod))));
+    Feedback = uvec4(page, lod, 1);
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "disk_cache.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+DiskCache::DiskCache(const fs::path& directory, std::uintmax_t max_bytes) :
+    directory_(directory),
+    max_bytes_(max_bytes)
+{
+    auto error = std::error_code {};
+    fs::create_directories(directory_, error);
+    Scan();
+}
+
+auto DiskCache::Get(std::string_view key) -> std::optional<FileData> {
+    const auto name = FileNameFor(key);
+    {
+        auto lock = std::scoped_lock {mutex_};
+        auto it = entries_.find(name);
+        if (it == entries_.end()) return std::nullopt;
+        lru_.splice(lru_.begin(), lru_, it->second);
+    }
+
+    const auto path = directory_ / name;
+    auto data = BlockingFileReader::Read(path);
+    if (!data) return std::nullopt;
+
+    auto error = std::error_code {};
+    fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+    return std::move(data.value());
+}
+
+auto DiskCache::Locate(std::string_view key) -> std::optional<fs::path> {
+    const auto name = FileNameFor(key);
+    {
+        auto lock = std::scoped_lock {mutex_};
+        auto it = entries_.find(name);
+        if (it == entries_.end()) return std::nullopt;
+        lru_.splice(lru_.begin(), lru_, it->second);
+    }
+
+    const auto path = directory_ / name;
+    auto error = std::error_code {};
+    fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+    return path;
+}
+
+auto DiskCache::Put(std::string_view key, std::span<const unsigned char> bytes) -> void {
+    if (bytes.size() > max_bytes_) return;
+
+    const auto name = FileNameFor(key);
+    const auto path = directory_ / name;
+
+    // Write to a private name first so that readers never see a partial file.
+    auto temp = path;
+    temp += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        auto file = std::ofstream {temp, std::ios::binary};
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) return;
+    }
+
+    auto error = std::error_code {};
+    fs::rename(temp, path, error);
+    if (error) {
+        fs::remove(temp, error);
+        return;
+    }
+
+    auto lock = std::scoped_lock {mutex_};
+    if (auto it = entries_.find(name); it != entries_.end()) {
+        total_bytes_ -= it->second->size;
+        lru_.erase(it->second);
+    }
+    lru_.push_front({.name = name, .size = bytes.size()});
+    entries_[name] = lru_.begin();
+    total_bytes_ += bytes.size();
+    Evict();
+}
+
+auto DiskCache::SizeBytes() const -> std::uintmax_t {
+    auto lock = std::scoped_lock {mutex_};
+    return total_bytes_;
+}
+
+auto DiskCache::Scan() -> void {
+    struct Found {
+        Entry entry;
+        fs::file_time_type time;
+    };
+
+    auto found = std::vector<Found> {};
+    auto error = std::error_code {};
+    for (const auto& file : fs::directory_iterator {directory_, error}) {
+        if (!file.is_regular_file() || file.path().extension() == ".tmp") continue;
+        found.emplace_back(Found {
+            .entry = {.name = file.path().filename().string(), .size = file.file_size()},
+            .time = file.last_write_time()
+        });
+    }
+
+    std::ranges::sort(found, std::ranges::greater {}, &Found::time);
+    for (auto& item : found) {
+        total_bytes_ += item.entry.size;
+        lru_.push_back(std::move(item.entry));
+        entries_[lru_.back().name] = std::prev(lru_.end());
+    }
+    Evict();
+}
+
+auto DiskCache::Evict() -> void {
+    while (total_bytes_ > max_bytes_ && !lru_.empty()) {
+        const auto& victim = lru_.back();
+        auto error = std::error_code {};
+        fs::remove(directory_ / victim.name, error);
+        total_bytes_ -= victim.size;
+        entries_.erase(victim.name);
+        lru_.pop_back();
+    }
+}
+
+auto DiskCache::FileNameFor(std::string_view key) -> std::string {
+    // FNV-1a keeps names short and filesystem-safe; the extension is kept so
+    // that cached payloads still pass the loader's file type check.
+    auto hash = std::uint64_t {14695981039346656037ull};
+    for (auto c : key) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return std::format("{:016x}{}", hash, fs::path {key}.extension().string());
+}
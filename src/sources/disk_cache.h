@@ -0,0 +1,62 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "loaders/file_reader.h"
+
+namespace fs = std::filesystem;
+
+// A persistent, size-bounded cache of fetched payloads. Entries are evicted
+// least recently used first; access order survives restarts through each
+// entry's modification time.
+class DiskCache {
+public:
+    DiskCache(const fs::path& directory, std::uintmax_t max_bytes);
+
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
+
+    [[nodiscard]] auto Get(std::string_view key) -> std::optional<FileData>;
+
+    // The file holding the entry, for callers that map it instead of
+    // reading it. Counts as a use, like Get().
+    [[nodiscard]] auto Locate(std::string_view key) -> std::optional<fs::path>;
+
+    auto Put(std::string_view key, std::span<const unsigned char> bytes) -> void;
+
+    [[nodiscard]] auto SizeBytes() const -> std::uintmax_t;
+
+private:
+    struct Entry {
+        std::string name;
+        std::uintmax_t size {0};
+    };
+
+    mutable std::mutex mutex_;
+
+    fs::path directory_;
+
+    std::uintmax_t max_bytes_ {0};
+    std::uintmax_t total_bytes_ {0};
+
+    // Most recently used at the front.
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+
+    auto Scan() -> void;
+
+    auto Evict() -> void;
+
+    static auto FileNameFor(std::string_view key) -> std::string;
+};
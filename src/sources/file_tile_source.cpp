@@ -0,0 +1,27 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "file_tile_source.h"
+
+#include <format>
+#include <print>
+
+FileTileSource::FileTileSource(const Parameters& params) : params_(params) {
+    const auto path = params_.root / PyramidManifest::kFileName;
+    auto error = std::error_code {};
+    if (!params_.use_manifest || !fs::exists(path, error)) return;
+
+    if (auto manifest = PyramidManifest::Load(path)) {
+        manifest_ = std::move(manifest.value());
+    } else {
+        std::println("{}", manifest.error());
+    }
+}
+
+auto FileTileSource::Locate(const TileId& id) const -> fs::path {
+    return params_.root / std::format("{}.png", id);
+}
+
+auto FileTileSource::CreateReader() const -> std::unique_ptr<FileReader> {
+    return FileReader::Create(params_.use_io_uring);
+}
@@ -0,0 +1,43 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+#include "sources/tile_source.h"
+
+namespace fs = std::filesystem;
+
+class FileTileSource : public TileSource {
+public:
+    struct Parameters {
+        fs::path root {"assets/tiles"};
+        bool use_io_uring {true};
+
+        // Reads PyramidManifest::kFileName from the root when there is one.
+        bool use_manifest {true};
+    };
+
+    explicit FileTileSource(const Parameters& params);
+
+    [[nodiscard]] auto Locate(const TileId& id) const -> fs::path override;
+
+    [[nodiscard]] auto CreateReader() const -> std::unique_ptr<FileReader> override;
+
+    // Never an io_uring reader, whose ring registers buffers of its own.
+    [[nodiscard]] auto CreateBlockingReader() const -> std::unique_ptr<FileReader> override {
+        return std::make_unique<BlockingFileReader>();
+    }
+
+    [[nodiscard]] auto Manifest() const -> const PyramidManifest* override {
+        return manifest_ ? &manifest_.value() : nullptr;
+    }
+
+private:
+    Parameters params_;
+
+    std::optional<PyramidManifest> manifest_;
+};
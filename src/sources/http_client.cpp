@@ -0,0 +1,426 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "http_client.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <string_view>
+#include <utility>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "core/buffer_pool.h"
+
+#ifdef MSG_NOSIGNAL
+static constexpr int kSendFlags {MSG_NOSIGNAL};
+#else
+static constexpr int kSendFlags {0};
+#endif
+
+// Status line and headers together, which is far more than any tile
+// server sends.
+static constexpr std::size_t kMaxHeaderBytes {64 * 1024};
+
+static auto allocateBody(std::size_t size) -> std::expected<FileData, std::string> {
+    auto bytes = FileBuffer {
+        static_cast<unsigned char*>(BufferPool::Get().Allocate(std::max<std::size_t>(size, 1))),
+        [](void* ptr) { BufferPool::Get().Free(ptr); }
+    };
+    if (bytes == nullptr) return std::unexpected(std::format("Failed to allocate a {} byte response body", size));
+    return FileData {.bytes = std::move(bytes), .size = size};
+}
+
+static auto toLower(std::string_view str) -> std::string {
+    auto out = std::string {str};
+    std::ranges::transform(out, out.begin(), [](unsigned char c) { return std::tolower(c); });
+    return out;
+}
+
+static auto trim(std::string_view str) -> std::string_view {
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.front()))) str.remove_prefix(1);
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.back()))) str.remove_suffix(1);
+    return str;
+}
+
+static auto fill(int socket, std::string& buffer) -> bool {
+    char chunk[64 * 1024];
+    const auto count = recv(socket, chunk, sizeof(chunk), 0);
+    if (count <= 0) return false;
+    buffer.append(chunk, static_cast<std::size_t>(count));
+    return true;
+}
+
+auto HttpClient::Get(const HttpRequest& request) -> HttpResult {
+    auto results = GetBatch(std::span {&request, 1});
+    return std::move(results.front());
+}
+
+auto HttpClient::GetBatch(std::span<const HttpRequest> requests) -> std::vector<HttpResult> {
+    auto results = std::vector<HttpResult> {};
+    for (const auto& request : requests) {
+        results.emplace_back(std::unexpected(std::format("Request for '{}' was not sent", request.path)));
+    }
+
+    auto pending = std::vector<std::size_t> {};
+    for (auto i = std::size_t {0}; i < requests.size(); ++i) pending.emplace_back(i);
+
+    // A request is retried once on a fresh connection if the one it was
+    // pipelined on went away before its response arrived.
+    const auto depth = std::max(1u, config_.pipeline_depth);
+    for (auto attempt = 0; attempt < 2 && !pending.empty(); ++attempt) {
+        auto failed = std::vector<std::size_t> {};
+
+        for (auto first = std::size_t {0}; first < pending.size(); first += depth) {
+            const auto last = std::min(pending.size(), first + depth);
+            const auto chunk = std::span {pending}.subspan(first, last - first);
+
+            auto connection = Acquire();
+            if (!connection) {
+                for (auto index : chunk) results[index] = std::unexpected(connection.error());
+                continue;
+            }
+
+            auto batch = std::vector<HttpRequest> {};
+            for (auto index : chunk) batch.emplace_back(requests[index]);
+
+            if (!Send(connection.value(), batch)) {
+                Release(std::move(connection.value()), false);
+                failed.insert(failed.end(), chunk.begin(), chunk.end());
+                continue;
+            }
+
+            // Resumed once the connection is back in the pool, since a resume
+            // needs a connection of its own and the pool may have no other.
+            auto short_reads = std::vector<std::pair<std::size_t, Response>> {};
+            auto reusable = true;
+            for (auto index : chunk) {
+                if (!reusable) {
+                    failed.emplace_back(index);
+                    continue;
+                }
+
+                auto response = ReadResponse(connection.value());
+                if (!response) {
+                    results[index] = std::unexpected(response.error());
+                    failed.emplace_back(index);
+                    reusable = false;
+                    continue;
+                }
+
+                reusable = response->keep_alive;
+                const auto& path = requests[index].path;
+                if (response->status == 304) {
+                    results[index] = HttpResponse {.not_modified = true};
+                } else if (response->status == 404) {
+                    results[index] = std::unexpected(std::format("{} '{}'", kFileNotFound, path));
+                } else if (response->status != 200 && response->status != 206) {
+                    results[index] = std::unexpected(std::format("HTTP {} for '{}'", response->status, path));
+                } else if (response->received < response->expected) {
+                    short_reads.emplace_back(index, std::move(response.value()));
+                } else {
+                    results[index] = HttpResponse {
+                        .body = std::move(response->body),
+                        .condition = std::move(response->condition)
+                    };
+                }
+            }
+
+            Release(std::move(connection.value()), reusable);
+            for (auto& [index, response] : short_reads) {
+                results[index] = Resume(requests[index], std::move(response));
+            }
+        }
+
+        pending = std::move(failed);
+    }
+
+    return results;
+}
+
+HttpClient::~HttpClient() {
+    for (auto& connection : idle_) {
+        close(connection.socket);
+    }
+}
+
+auto HttpClient::Acquire() -> std::expected<Connection, std::string> {
+    {
+        auto lock = std::unique_lock {mutex_};
+        available_.wait(lock, [this] {
+            return !idle_.empty() || open_connections_ < std::max(1u, config_.max_connections);
+        });
+        if (!idle_.empty()) {
+            auto connection = std::move(idle_.back());
+            idle_.pop_back();
+            return connection;
+        }
+        ++open_connections_;
+    }
+
+    auto connection = Connect();
+    if (!connection) {
+        auto lock = std::scoped_lock {mutex_};
+        --open_connections_;
+        available_.notify_one();
+    }
+    return connection;
+}
+
+auto HttpClient::Release(Connection connection, bool reusable) -> void {
+    auto lock = std::scoped_lock {mutex_};
+    if (reusable) {
+        idle_.emplace_back(std::move(connection));
+    } else {
+        close(connection.socket);
+        --open_connections_;
+    }
+    available_.notify_one();
+}
+
+auto HttpClient::Connect() const -> std::expected<Connection, std::string> {
+    auto hints = addrinfo {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    auto addresses = static_cast<addrinfo*>(nullptr);
+    const auto port = std::to_string(config_.port);
+    if (getaddrinfo(config_.host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        return std::unexpected(std::format("Failed to resolve '{}'", config_.host));
+    }
+
+    auto socket_fd = -1;
+    for (auto address = addresses; address != nullptr; address = address->ai_next) {
+        socket_fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (socket_fd < 0) continue;
+
+        auto timeout = timeval {
+            .tv_sec = config_.timeout_ms / 1000,
+            .tv_usec = (config_.timeout_ms % 1000) * 1000
+        };
+        setsockopt(socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(socket_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        auto enable = 1;
+        setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+#ifdef SO_NOSIGPIPE
+        setsockopt(socket_fd, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+
+        if (connect(socket_fd, address->ai_addr, address->ai_addrlen) == 0) break;
+        close(socket_fd);
+        socket_fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (socket_fd < 0) {
+        return std::unexpected(std::format("Failed to connect to {}:{}", config_.host, config_.port));
+    }
+    return Connection {.socket = socket_fd};
+}
+
+auto HttpClient::Send(Connection& connection, std::span<const HttpRequest> requests) const -> bool {
+    auto payload = std::string {};
+    for (const auto& request : requests) {
+        payload += FormatRequest(request);
+    }
+
+    auto sent = std::size_t {0};
+    while (sent < payload.size()) {
+        const auto count = send(connection.socket, payload.data() + sent, payload.size() - sent, kSendFlags);
+        if (count <= 0) return false;
+        sent += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+auto HttpClient::ReadResponse(Connection& connection) const -> std::expected<Response, std::string> {
+    auto& buffer = connection.buffer;
+
+    auto header_end = std::string::npos;
+    while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (buffer.size() > kMaxHeaderBytes) {
+            return std::unexpected(std::format("Response header from {} is too large", config_.host));
+        }
+        if (!fill(connection.socket, buffer)) {
+            return std::unexpected(std::format("Connection to {} closed", config_.host));
+        }
+    }
+
+    const auto header = buffer.substr(0, header_end);
+    buffer.erase(0, header_end + 4);
+
+    auto response = Response {};
+    auto content_length = std::optional<std::size_t> {};
+    auto chunked = false;
+
+    auto lines = std::string_view {header};
+    const auto status_end = lines.find("\r\n");
+    const auto status_line = lines.substr(0, status_end);
+    if (!status_line.starts_with("HTTP/1.1")) response.keep_alive = false;
+    if (status_line.size() >= 12) {
+        std::from_chars(status_line.data() + 9, status_line.data() + 12, response.status);
+    }
+
+    lines.remove_prefix(status_end == std::string_view::npos ? lines.size() : status_end + 2);
+    while (!lines.empty()) {
+        const auto line_end = lines.find("\r\n");
+        const auto line = lines.substr(0, line_end);
+        lines.remove_prefix(line_end == std::string_view::npos ? lines.size() : line_end + 2);
+
+        const auto colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        const auto key = toLower(trim(line.substr(0, colon)));
+        const auto value = trim(line.substr(colon + 1));
+
+        if (key == "content-length") {
+            auto length = std::size_t {0};
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), length);
+            if (error != std::errc {} || end != value.data() + value.size()) {
+                return std::unexpected(std::format("Invalid Content-Length '{}' from {}", value, config_.host));
+            }
+            if (length > config_.max_body_bytes) {
+                return std::unexpected(std::format("Response of {} bytes from {} is over the limit", length, config_.host));
+            }
+            content_length = length;
+        } else if (key == "transfer-encoding") {
+            chunked = toLower(value).contains("chunked");
+        } else if (key == "connection") {
+            response.keep_alive = toLower(value) != "close";
+        } else if (key == "etag") {
+            response.condition = std::format("If-None-Match: {}", value);
+        } else if (key == "last-modified" && !response.condition.starts_with("If-None-Match")) {
+            response.condition = std::format("If-Modified-Since: {}", value);
+        }
+    }
+
+    // A 304 has no body whatever its headers say, and must not be read to close.
+    if (response.status == 304) {
+        chunked = false;
+        content_length = 0;
+    }
+
+    if (chunked) {
+        auto body = std::string {};
+        while (true) {
+            auto line_end = std::string::npos;
+            while ((line_end = buffer.find("\r\n")) == std::string::npos) {
+                if (!fill(connection.socket, buffer)) return std::unexpected("Truncated chunked response");
+            }
+            // Chunk extensions after ';' are ignored.
+            auto size = std::size_t {0};
+            const auto [end, error] = std::from_chars(buffer.data(), buffer.data() + line_end, size, 16);
+            if (error != std::errc {} || end == buffer.data()) return std::unexpected("Invalid chunk size");
+            if (size > config_.max_body_bytes - body.size()) {
+                return std::unexpected(std::format("Chunked response from {} is over the limit", config_.host));
+            }
+            buffer.erase(0, line_end + 2);
+
+            while (buffer.size() < size + 2) {
+                if (!fill(connection.socket, buffer)) return std::unexpected("Truncated chunked response");
+            }
+            if (size == 0) {
+                // Trailers are not used; expect the terminating empty line.
+                buffer.erase(0, 2);
+                break;
+            }
+            body.append(buffer, 0, size);
+            buffer.erase(0, size + 2);
+        }
+
+        auto allocated = allocateBody(body.size());
+        if (!allocated) return std::unexpected(allocated.error());
+        response.body = std::move(allocated.value());
+        std::memcpy(response.body.bytes.get(), body.data(), body.size());
+        response.received = response.expected = body.size();
+        return response;
+    }
+
+    if (!content_length) {
+        // Without a length the body runs to the end of the connection.
+        response.keep_alive = false;
+        while (buffer.size() <= config_.max_body_bytes && fill(connection.socket, buffer)) {}
+        if (buffer.size() > config_.max_body_bytes) {
+            return std::unexpected(std::format("Response from {} is over the limit", config_.host));
+        }
+        content_length = buffer.size();
+    }
+
+    response.expected = content_length.value();
+    auto allocated = allocateBody(response.expected);
+    if (!allocated) return std::unexpected(allocated.error());
+    response.body = std::move(allocated.value());
+
+    const auto buffered = std::min(buffer.size(), response.expected);
+    std::memcpy(response.body.bytes.get(), buffer.data(), buffered);
+    buffer.erase(0, buffered);
+    response.received = buffered;
+
+    while (response.received < response.expected) {
+        const auto count = recv(
+            connection.socket,
+            response.body.bytes.get() + response.received,
+            response.expected - response.received,
+            0
+        );
+        if (count <= 0) {
+            response.keep_alive = false;
+            break;
+        }
+        response.received += static_cast<std::size_t>(count);
+    }
+
+    return response;
+}
+
+auto HttpClient::Resume(const HttpRequest& request, Response response) -> HttpResult {
+    if (response.received == 0) {
+        return std::unexpected(std::format("Empty response for '{}'", request.path));
+    }
+
+    const auto offset = request.range ? request.range->offset : 0;
+    auto remaining = Get({
+        .path = request.path,
+        .range = ByteRange {
+            .offset = offset + response.received,
+            .length = response.expected - response.received
+        }
+    });
+
+    if (!remaining) return std::unexpected(remaining.error());
+    if (remaining->body.size != response.expected - response.received) {
+        return std::unexpected(std::format("Range request for '{}' returned the wrong size", request.path));
+    }
+
+    std::memcpy(response.body.bytes.get() + response.received, remaining->body.bytes.get(), remaining->body.size);
+    return HttpResponse {.body = std::move(response.body), .condition = std::move(response.condition)};
+}
+
+auto HttpClient::FormatRequest(const HttpRequest& request) const -> std::string {
+    auto message = std::format(
+        "GET {} HTTP/1.1\r\nHost: {}:{}\r\nConnection: keep-alive\r\n",
+        request.path,
+        config_.host,
+        config_.port
+    );
+    if (request.range) {
+        message += std::format(
+            "Range: bytes={}-{}\r\n",
+            request.range->offset,
+            request.range->offset + request.range->length - 1
+        );
+    }
+    if (!request.condition.empty()) {
+        message += std::format("{}\r\n", request.condition);
+    }
+    message += "\r\n";
+    return message;
+}
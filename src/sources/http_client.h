@@ -0,0 +1,107 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <expected>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "loaders/file_reader.h"
+
+struct ByteRange {
+    std::size_t offset {0};
+    std::size_t length {0};
+};
+
+struct HttpRequest {
+    std::string path;
+    std::optional<ByteRange> range {};
+
+    // A header line such as `If-None-Match: "etag"`, as HttpResponse hands
+    // it out, asking the server to answer 304 if the copy is current.
+    std::string condition {};
+};
+
+struct HttpResponse {
+    FileData body {};
+
+    // The server answered a conditional request with 304; body is empty.
+    bool not_modified {false};
+
+    // The header line to revalidate this body with later, built from its
+    // ETag or else its Last-Modified; empty when the server sent neither.
+    std::string condition {};
+};
+
+using HttpResult = std::expected<HttpResponse, std::string>;
+
+// A minimal HTTP/1.1 GET client for a single origin. Connections are kept
+// alive and pooled, and a batch of requests is pipelined over each one.
+// Bodies that are cut short are resumed with a Range request.
+class HttpClient {
+public:
+    struct Config {
+        std::string host {"localhost"};
+        int port {80};
+        unsigned max_connections {4};
+        unsigned pipeline_depth {8};
+        int timeout_ms {10000};
+
+        // Responses that declare or send more than this are refused, so a
+        // bad server cannot make the client allocate without bound.
+        std::size_t max_body_bytes {64 * 1024 * 1024};
+    };
+
+    explicit HttpClient(const Config& config) : config_(config) {}
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    [[nodiscard]] auto Get(const HttpRequest& request) -> HttpResult;
+
+    [[nodiscard]] auto GetBatch(std::span<const HttpRequest> requests) -> std::vector<HttpResult>;
+
+    ~HttpClient();
+
+private:
+    struct Connection {
+        int socket {-1};
+        std::string buffer {};
+    };
+
+    struct Response {
+        int status {0};
+        FileData body {};
+        std::size_t received {0};
+        std::size_t expected {0};
+        bool keep_alive {true};
+        std::string condition {};
+    };
+
+    Config config_;
+
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<Connection> idle_;
+    unsigned open_connections_ {0};
+
+    auto Acquire() -> std::expected<Connection, std::string>;
+
+    auto Release(Connection connection, bool reusable) -> void;
+
+    auto Connect() const -> std::expected<Connection, std::string>;
+
+    auto Send(Connection& connection, std::span<const HttpRequest> requests) const -> bool;
+
+    auto ReadResponse(Connection& connection) const -> std::expected<Response, std::string>;
+
+    auto Resume(const HttpRequest& request, Response response) -> HttpResult;
+
+    auto FormatRequest(const HttpRequest& request) const -> std::string;
+};
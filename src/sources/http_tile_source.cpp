@@ -0,0 +1,150 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "http_tile_source.h"
+
+#include <charconv>
+#include <format>
+#include <vector>
+
+// Stored next to each cached body: the conditional header to revalidate it with.
+static constexpr auto kConditionSuffix = std::string_view {".condition"};
+
+class HttpReader : public FileReader {
+public:
+    HttpReader(
+        std::shared_ptr<HttpClient> client,
+        std::shared_ptr<DiskCache> cache,
+        std::shared_ptr<HttpTileSource::Validated> validated,
+        std::string origin
+    ) :
+        client_(std::move(client)),
+        cache_(std::move(cache)),
+        validated_(std::move(validated)),
+        origin_(std::move(origin)) {}
+
+    [[nodiscard]] auto ReadBatch(std::span<const fs::path> paths) -> std::vector<ReadResult> override {
+        auto results = std::vector<ReadResult>(paths.size());
+        auto requests = std::vector<HttpRequest> {};
+        auto keys = std::vector<std::string> {};
+        auto stale = std::vector<std::optional<FileData>> {};
+        auto missing = std::vector<std::size_t> {};
+
+        for (auto i = std::size_t {0}; i < paths.size(); ++i) {
+            const auto path = paths[i].generic_string();
+            auto key = origin_ + path;
+            auto cached = cache_->Get(key);
+            if (cached && IsValidated(key)) {
+                results[i] = std::move(cached.value());
+                continue;
+            }
+
+            // Entries from earlier sessions are checked once with the server;
+            // one without a condition is simply fetched again.
+            auto request = HttpRequest {.path = path};
+            if (cached) {
+                if (const auto condition = cache_->Get(key + std::string {kConditionSuffix})) {
+                    const auto bytes = condition->Bytes();
+                    request.condition.assign(bytes.begin(), bytes.end());
+                }
+            }
+            requests.emplace_back(std::move(request));
+            keys.emplace_back(std::move(key));
+            stale.emplace_back(std::move(cached));
+            missing.emplace_back(i);
+        }
+
+        auto responses = client_->GetBatch(requests);
+        for (auto i = std::size_t {0}; i < missing.size(); ++i) {
+            auto& response = responses[i];
+            auto& result = results[missing[i]];
+            if (response && response->not_modified && stale[i]) {
+                result = std::move(stale[i].value());
+            } else if (response && !response->not_modified) {
+                cache_->Put(keys[i], response->body.Bytes());
+                const auto& condition = response->condition;
+                cache_->Put(keys[i] + std::string {kConditionSuffix}, std::span {
+                    reinterpret_cast<const unsigned char*>(condition.data()),
+                    condition.size()
+                });
+                result = std::move(response->body);
+            } else if (stale[i]) {
+                // The server is unreachable or misbehaving; the cached copy
+                // is better than nothing, and is checked again next time.
+                result = std::move(stale[i].value());
+                continue;
+            } else {
+                result = std::unexpected(
+                    response ? std::format("Unexpected 304 for '{}'", requests[i].path) : response.error()
+                );
+                continue;
+            }
+            MarkValidated(keys[i]);
+        }
+
+        return results;
+    }
+
+    [[nodiscard]] auto MaxBatchSize() const -> std::size_t override {
+        return 32;
+    }
+
+private:
+    std::shared_ptr<HttpClient> client_;
+    std::shared_ptr<DiskCache> cache_;
+    std::shared_ptr<HttpTileSource::Validated> validated_;
+    std::string origin_;
+
+    auto IsValidated(const std::string& key) const -> bool {
+        auto lock = std::scoped_lock {validated_->mutex};
+        return validated_->keys.contains(key);
+    }
+
+    auto MarkValidated(const std::string& key) -> void {
+        auto lock = std::scoped_lock {validated_->mutex};
+        validated_->keys.insert(key);
+    }
+};
+
+HttpTileSource::HttpTileSource(const Parameters& params) :
+    params_(params),
+    client_(std::make_shared<HttpClient>(params.client)),
+    cache_(std::make_shared<DiskCache>(params.cache_directory, params.cache_max_bytes)),
+    validated_(std::make_shared<Validated>()) {}
+
+auto HttpTileSource::FromUrl(std::string_view url) -> std::optional<Parameters> {
+    constexpr auto scheme = std::string_view {"http://"};
+    if (!url.starts_with(scheme)) return std::nullopt;
+    url.remove_prefix(scheme.size());
+
+    auto params = Parameters {};
+    const auto path_start = url.find('/');
+    const auto authority = url.substr(0, path_start);
+    params.prefix = path_start == std::string_view::npos ? "" : std::string {url.substr(path_start)};
+    while (params.prefix.ends_with('/')) params.prefix.pop_back();
+
+    const auto colon = authority.find(':');
+    params.client.host = std::string {authority.substr(0, colon)};
+    if (colon != std::string_view::npos) {
+        const auto port = authority.substr(colon + 1);
+        const auto [end, error] = std::from_chars(port.data(), port.data() + port.size(), params.client.port);
+        if (error != std::errc {} || end != port.data() + port.size()) return std::nullopt;
+        if (params.client.port <= 0 || params.client.port > 65535) return std::nullopt;
+    }
+
+    if (params.client.host.empty()) return std::nullopt;
+    return params;
+}
+
+auto HttpTileSource::Locate(const TileId& id) const -> fs::path {
+    return std::format("{}/{}.png", params_.prefix, id);
+}
+
+auto HttpTileSource::CreateReader() const -> std::unique_ptr<FileReader> {
+    return std::make_unique<HttpReader>(
+        client_,
+        cache_,
+        validated_,
+        std::format("{}:{}", params_.client.host, params_.client.port)
+    );
+}
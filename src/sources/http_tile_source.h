@@ -0,0 +1,55 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "sources/disk_cache.h"
+#include "sources/http_client.h"
+#include "sources/tile_source.h"
+
+namespace fs = std::filesystem;
+
+// Fetches tiles from a tile server. Every reader shares one connection pool
+// and one persistent disk cache, keyed by host and port so servers sharing a
+// cache directory never see each other's tiles. Entries from an earlier
+// session are revalidated against the server once before they are trusted.
+class HttpTileSource : public TileSource {
+public:
+    struct Parameters {
+        HttpClient::Config client {};
+        std::string prefix {"/tiles"};
+        fs::path cache_directory {"cache/http"};
+        std::uintmax_t cache_max_bytes {512ull * 1024 * 1024};
+    };
+
+    explicit HttpTileSource(const Parameters& params);
+
+    // Parses "http://host[:port][/prefix]".
+    [[nodiscard]] static auto FromUrl(std::string_view url) -> std::optional<Parameters>;
+
+    [[nodiscard]] auto Locate(const TileId& id) const -> fs::path override;
+
+    [[nodiscard]] auto CreateReader() const -> std::unique_ptr<FileReader> override;
+
+    // Cache keys already checked against the server this session.
+    struct Validated {
+        std::mutex mutex;
+        std::unordered_set<std::string> keys;
+    };
+
+private:
+    Parameters params_;
+
+    std::shared_ptr<HttpClient> client_;
+    std::shared_ptr<DiskCache> cache_;
+    std::shared_ptr<Validated> validated_;
+};
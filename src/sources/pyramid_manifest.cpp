@@ -0,0 +1,224 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "pyramid_manifest.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <limits>
+
+static constexpr std::array<char, 4> kMagic {'T', 'S', 'P', 'M'};
+static constexpr std::uint32_t kVersion {2};
+
+using IndexedValues = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+
+static auto wordsFor(std::size_t bits) -> std::size_t {
+    return (bits + 63) / 64;
+}
+
+template <typename T>
+static auto write(std::ofstream& file, const T& value) -> void {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static auto read(std::ifstream& file, T& value) -> bool {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+static auto find(const IndexedValues& values, std::uint32_t index) -> std::optional<std::uint32_t> {
+    const auto it = std::ranges::lower_bound(values, index, {}, &IndexedValues::value_type::first);
+    if (it == values.end() || it->first != index) return std::nullopt;
+    return it->second;
+}
+
+static auto insert(IndexedValues& values, std::uint32_t index, std::uint32_t value) -> void {
+    const auto it = std::ranges::lower_bound(values, index, {}, &IndexedValues::value_type::first);
+    if (it != values.end() && it->first == index) {
+        it->second = value;
+    } else {
+        values.emplace(it, index, value);
+    }
+}
+
+static auto writeValues(std::ofstream& file, const IndexedValues& values) -> void {
+    write(file, static_cast<std::uint32_t>(values.size()));
+    for (const auto& [index, value] : values) {
+        write(file, index);
+        write(file, value);
+    }
+}
+
+static auto remaining(std::ifstream& file, std::uintmax_t size) -> std::uintmax_t {
+    const auto offset = static_cast<std::uintmax_t>(file.tellg());
+    return offset < size ? size - offset : 0;
+}
+
+// Indices must be below `tiles` and strictly ascending, which also bounds
+// the count, and the file must hold every entry before any is allocated.
+static auto readValues(std::ifstream& file, std::uintmax_t size, std::size_t tiles, IndexedValues& values) -> bool {
+    auto count = std::uint32_t {0};
+    if (!read(file, count)) return false;
+    if (count > tiles || std::uintmax_t {count} * 2 * sizeof(std::uint32_t) > remaining(file, size)) return false;
+
+    values.resize(count);
+    for (auto i = std::size_t {0}; i < values.size(); ++i) {
+        auto& [index, value] = values[i];
+        if (!read(file, index) || !read(file, value) || index >= tiles) return false;
+        if (i > 0 && index <= values[i - 1].first) return false;
+    }
+    return true;
+}
+
+auto PyramidManifest::Geometry::IsValid() const -> bool {
+    return width > 0 && height > 0 && tile_size > 0 && lods > 0 && lods <= 31 &&
+           (std::int64_t {tile_size} << (lods - 1)) <= std::numeric_limits<int>::max();
+}
+
+PyramidManifest::PyramidManifest(const Geometry& geometry) : geometry_(geometry) {
+    for (auto lod = 0; lod < geometry.lods; ++lod) {
+        const auto size = static_cast<float>(geometry.tile_size * (1 << lod));
+        auto& level = levels_.emplace_back(Level {
+            .tiles_x = static_cast<int>(std::ceil(static_cast<float>(geometry.width) / size)),
+            .tiles_y = static_cast<int>(std::ceil(static_cast<float>(geometry.height) / size)),
+            .exists = {},
+            .solid = {},
+            .groups = {}
+        });
+        level.exists.assign(wordsFor(static_cast<std::size_t>(level.tiles_x) * level.tiles_y), 0);
+    }
+}
+
+auto PyramidManifest::Load(const fs::path& path) -> std::expected<PyramidManifest, std::string> {
+    auto file = std::ifstream {path, std::ios::binary};
+    auto error = std::error_code {};
+    const auto size = fs::file_size(path, error);
+    if (!file || error) return std::unexpected(std::format("Failed to open manifest '{}'", path.string()));
+
+    auto magic = std::array<char, 4> {};
+    auto version = std::uint32_t {0};
+    auto geometry = Geometry {};
+    if (!read(file, magic) || magic != kMagic || !read(file, version) || version != kVersion) {
+        return std::unexpected(std::format("'{}' is not a version {} manifest", path.string(), kVersion));
+    }
+    // The existence bitmaps, one bit per tile, have to fit in the file.
+    const auto invalid = std::unexpected(std::format("Invalid geometry in manifest '{}'", path.string()));
+    if (!read(file, geometry) || !geometry.IsValid()) return invalid;
+    const auto tiles = (std::uintmax_t {static_cast<unsigned>(geometry.width)} + geometry.tile_size - 1) / geometry.tile_size *
+                       ((std::uintmax_t {static_cast<unsigned>(geometry.height)} + geometry.tile_size - 1) / geometry.tile_size);
+    if (tiles / 8 > remaining(file, size)) return invalid;
+
+    const auto corrupt = std::unexpected(std::format("Manifest '{}' is truncated or corrupt", path.string()));
+    auto manifest = PyramidManifest {geometry};
+    for (auto& level : manifest.levels_) {
+        const auto count = static_cast<std::size_t>(level.tiles_x) * level.tiles_y;
+        const auto bytes = static_cast<std::streamsize>(level.exists.size() * sizeof(std::uint64_t));
+        if (!file.read(reinterpret_cast<char*>(level.exists.data()), bytes)) return corrupt;
+        if (!readValues(file, size, count, level.solid) || !readValues(file, size, count, level.groups)) return corrupt;
+    }
+
+    auto groups = std::uint32_t {0};
+    if (!read(file, groups) || std::uintmax_t {groups} * sizeof(TileId) > remaining(file, size)) return corrupt;
+    manifest.group_sources_.resize(groups);
+    for (auto& source : manifest.group_sources_) {
+        if (!read(file, source) || source.lod >= static_cast<unsigned>(geometry.lods)) return corrupt;
+        if (source.x < 0 || source.y < 0 || source.x >= manifest.TilesX(source.lod) || source.y >= manifest.TilesY(source.lod)) {
+            return corrupt;
+        }
+    }
+
+    // Every member has to name a group that exists.
+    for (const auto& level : manifest.levels_) {
+        for (const auto& [index, group] : level.groups) {
+            if (group >= groups) return corrupt;
+        }
+    }
+    return manifest;
+}
+
+auto PyramidManifest::Save(const fs::path& path) const -> std::expected<void, std::string> {
+    auto file = std::ofstream {path, std::ios::binary};
+    write(file, kMagic);
+    write(file, kVersion);
+    write(file, geometry_);
+    for (const auto& level : levels_) {
+        file.write(
+            reinterpret_cast<const char*>(level.exists.data()),
+            static_cast<std::streamsize>(level.exists.size() * sizeof(std::uint64_t))
+        );
+        writeValues(file, level.solid);
+        writeValues(file, level.groups);
+    }
+
+    write(file, static_cast<std::uint32_t>(group_sources_.size()));
+    for (const auto& source : group_sources_) write(file, source);
+
+    if (!file) return std::unexpected(std::format("Failed to write manifest '{}'", path.string()));
+    return {};
+}
+
+auto PyramidManifest::MarkPresent(const TileId& id) -> void {
+    const auto index = Index(id);
+    levels_[id.lod].exists[index / 64] |= std::uint64_t {1} << (index % 64);
+}
+
+auto PyramidManifest::MarkSolid(const TileId& id, std::uint32_t rgba) -> void {
+    MarkPresent(id);
+    insert(levels_[id.lod].solid, Index(id), rgba);
+}
+
+auto PyramidManifest::Exists(const TileId& id) const -> bool {
+    const auto index = Index(id);
+    return (levels_[id.lod].exists[index / 64] >> (index % 64)) & 1;
+}
+
+auto PyramidManifest::SolidColor(const TileId& id) const -> std::optional<std::uint32_t> {
+    return find(levels_[id.lod].solid, Index(id));
+}
+
+auto PyramidManifest::AddGroup(const TileId& source) -> std::uint32_t {
+    group_sources_.emplace_back(source);
+    return static_cast<std::uint32_t>(group_sources_.size() - 1);
+}
+
+auto PyramidManifest::MarkDuplicate(const TileId& id, std::uint32_t group) -> void {
+    MarkPresent(id);
+    insert(levels_[id.lod].groups, Index(id), group);
+}
+
+auto PyramidManifest::Group(const TileId& id) const -> std::optional<std::uint32_t> {
+    return find(levels_[id.lod].groups, Index(id));
+}
+
+auto PyramidManifest::SolidColorOf(const Image& image) -> std::optional<std::uint32_t> {
+    const auto pixel = image.BytesPerPixel();
+    const auto bytes = image.Bytes();
+    const auto data = image.Data();
+    if (data == nullptr || bytes < pixel) return std::nullopt;
+
+    for (auto offset = pixel; offset < bytes; offset += pixel) {
+        if (std::memcmp(data, data + offset, pixel) != 0) return std::nullopt;
+    }
+
+    // 16-bit channels keep their high byte.
+    auto channels = std::array<std::uint32_t, 4> {0, 0, 0, 255};
+    for (auto c = 0u; c < image.depth; ++c) {
+        if (image.bit_depth == 16) {
+            auto value = std::uint16_t {0};
+            std::memcpy(&value, data + c * 2, sizeof(value));
+            channels[c] = value >> 8;
+        } else {
+            channels[c] = data[c];
+        }
+    }
+    if (image.depth <= 2) {
+        channels[3] = image.depth == 2 ? channels[1] : 255;
+        channels[1] = channels[0];
+        channels[2] = channels[0];
+    }
+    return channels[0] | channels[1] << 8 | channels[2] << 16 | channels[3] << 24;
+}
@@ -0,0 +1,118 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/image.h"
+#include "tile.h"
+
+namespace fs = std::filesystem;
+
+// What a pyramid holds, read once at startup so that tiles which do not
+// exist are never requested, and tiles of a single solid colour are drawn
+// without touching their file. Large slides are mostly empty background,
+// which makes both common.
+//
+// Tiles with byte-identical content form groups. A group is read from
+// the file of its source tile, and loaded and uploaded once for all
+// of its members.
+//
+// On disk: the geometry, then per LOD a bitmap of the tiles that exist,
+// the colours of the solid ones and the groups of the duplicated ones,
+// both sorted by tile index, then the source tile of every group.
+class PyramidManifest {
+public:
+    static constexpr std::string_view kFileName {"manifest.bin"};
+
+    struct Geometry {
+        int width {0};
+        int height {0};
+        int tile_size {0};
+        int lods {0};
+
+        // Positive sizes, and few enough LODs that the coarsest tile's
+        // extent fits in an int.
+        [[nodiscard]] auto IsValid() const -> bool;
+
+        auto operator==(const Geometry&) const -> bool = default;
+    };
+
+    explicit PyramidManifest(const Geometry& geometry);
+
+    [[nodiscard]] static auto Load(const fs::path& path) -> std::expected<PyramidManifest, std::string>;
+
+    [[nodiscard]] auto Save(const fs::path& path) const -> std::expected<void, std::string>;
+
+    auto MarkPresent(const TileId& id) -> void;
+
+    // Marks the tile as present and one solid colour, packed RGBA8 with red
+    // in the low byte.
+    auto MarkSolid(const TileId& id, std::uint32_t rgba) -> void;
+
+    [[nodiscard]] auto Exists(const TileId& id) const -> bool;
+
+    [[nodiscard]] auto SolidColor(const TileId& id) const -> std::optional<std::uint32_t>;
+
+    // Starts a group of identical tiles stored in the source tile's file.
+    auto AddGroup(const TileId& source) -> std::uint32_t;
+
+    // Marks the tile as present and holding its group's content.
+    auto MarkDuplicate(const TileId& id, std::uint32_t group) -> void;
+
+    [[nodiscard]] auto Group(const TileId& id) const -> std::optional<std::uint32_t>;
+
+    [[nodiscard]] auto GroupSource(std::uint32_t group) const -> const TileId& {
+        return group_sources_[group];
+    }
+
+    [[nodiscard]] auto GroupCount() const -> std::size_t {
+        return group_sources_.size();
+    }
+
+    [[nodiscard]] auto GetGeometry() const -> const Geometry& {
+        return geometry_;
+    }
+
+    [[nodiscard]] auto TilesX(unsigned lod) const -> int {
+        return levels_[lod].tiles_x;
+    }
+
+    [[nodiscard]] auto TilesY(unsigned lod) const -> int {
+        return levels_[lod].tiles_y;
+    }
+
+    // The image's colour if every pixel is the same, widened to RGBA8 the
+    // way Texture2D swizzles gray tiles.
+    [[nodiscard]] static auto SolidColorOf(const Image& image) -> std::optional<std::uint32_t>;
+
+private:
+    struct Level {
+        int tiles_x {0};
+        int tiles_y {0};
+
+        std::vector<std::uint64_t> exists;
+
+        // Tile index and colour, and tile index and group, sorted by index.
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> solid;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> groups;
+    };
+
+    Geometry geometry_;
+
+    std::vector<Level> levels_;
+
+    std::vector<TileId> group_sources_;
+
+    [[nodiscard]] auto Index(const TileId& id) const -> std::uint32_t {
+        return static_cast<std::uint32_t>(id.y * levels_[id.lod].tiles_x + id.x);
+    }
+};
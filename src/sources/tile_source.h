@@ -0,0 +1,36 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+#include "loaders/file_reader.h"
+#include "sources/pyramid_manifest.h"
+#include "tile.h"
+
+namespace fs = std::filesystem;
+
+// Where tile bytes come from. A source maps tile ids to locations and hands
+// each I/O worker its own reader for them.
+class TileSource {
+public:
+    [[nodiscard]] virtual auto Locate(const TileId& id) const -> fs::path = 0;
+
+    [[nodiscard]] virtual auto CreateReader() const -> std::unique_ptr<FileReader> = 0;
+
+    // A reader for threads that read a tile or a few at a time and wait on
+    // each read, such as preload and generator workers. Sources whose
+    // batched reader holds costly resources hand out a plain one instead.
+    [[nodiscard]] virtual auto CreateBlockingReader() const -> std::unique_ptr<FileReader> {
+        return CreateReader();
+    }
+
+    // Which tiles exist and which are solid, if the source knows.
+    [[nodiscard]] virtual auto Manifest() const -> const PyramidManifest* {
+        return nullptr;
+    }
+
+    virtual ~TileSource() = default;
+};
@@ -4,12 +4,13 @@
 #include "tile.h"
 
 #include <glm/mat4x4.hpp>
-#include <glm/gtc/matrix_transform.hpp>
 
 auto Tile::Transform() const -> glm::mat4 {
-    return glm::translate(glm::mat4(1.0f), glm::vec3 {
-        position.x + size.x / 2.0f,
-        position.y + size.y / 2.0f,
-        0.0f
-    }) * glm::scale(glm::mat4(1.0f), glm::vec3 {scale, scale, 1.0f});
+    // translate(center) * scale(scale, scale, 1), written out directly.
+    auto transform = glm::mat4 {1.0f};
+    transform[0][0] = scale;
+    transform[1][1] = scale;
+    transform[3][0] = position.x + size.x / 2.0f;
+    transform[3][1] = position.y + size.y / 2.0f;
+    return transform;
 }
\ No newline at end of file
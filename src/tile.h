@@ -3,22 +3,32 @@
 
 #pragma once
 
+#include <cstdint>
 #include <format>
 #include <memory>
 
 #include <glm/vec2.hpp>
 #include <glm/mat4x4.hpp>
 
-#include "core/texture2d.h"
-#include "loaders/image_loader.h"
+#include "core/image.h"
 
-enum class TileState {
+enum class TileState : std::uint8_t {
     Unloaded,
     Loading,
+    Decoded,
     Loaded,
-    Error
+    Error,
+
+    // Not in the pyramid, as recorded by its manifest. Never requested.
+    Missing
 };
 
+// Identifies a tile's texture to whichever renderer owns it, so that the
+// tiling logic never depends on a graphics API.
+using TextureHandle = unsigned int;
+
+inline constexpr TextureHandle kNoTexture {0};
+
 struct TileId {
     unsigned lod;
     int x;
@@ -35,6 +45,8 @@ struct std::formatter<TileId> : std::formatter<std::string> {
     }
 };
 
+// A drawable tile as handed to the renderer. Tiles are stored per LOD in
+// a TileLevel; this is just the view of one of them needed to draw it.
 struct Tile {
     TileId id;
 
@@ -43,21 +55,16 @@ struct Tile {
 
     float scale;
 
-    bool visible {false};
-
-    TileState state {TileState::Unloaded};
-
-    Texture2D texture;
-
-    Tile(
-        const TileId& id,
-        const glm::vec2 position,
-        const glm::vec2 size,
-        const float scale
-    ) : id(id),
-        position(position),
-        size(size),
-        scale(scale) {}
+    TextureHandle texture {kNoTexture};
 
     [[nodiscard]] auto Transform() const -> glm::mat4;
+};
+
+// An entry of the render list: a loaded tile with its model matrix
+// computed once, when the tile entered the list. Tiles without a texture
+// are solid and drawn in their packed RGBA8 colour.
+struct RenderTile {
+    glm::mat4 model;
+    TextureHandle texture {kNoTexture};
+    std::uint32_t color {0};
 };
\ No newline at end of file
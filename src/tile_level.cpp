@@ -0,0 +1,126 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "tile_level.h"
+
+#include <bit>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define TILE_LEVEL_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TILE_LEVEL_SSE2
+#endif
+
+TileLevel::TileLevel(unsigned lod, int tiles_x, int tiles_y, float tile_extent) :
+    lod_(lod),
+    tiles_x_(static_cast<std::size_t>(tiles_x)),
+    tile_extent_(tile_extent)
+{
+    const auto count = static_cast<std::size_t>(tiles_x) * tiles_y;
+    min_x.reserve(count);
+    min_y.reserve(count);
+    max_x.reserve(count);
+    max_y.reserve(count);
+
+    for (auto y = 0; y < tiles_y; ++y) {
+        for (auto x = 0; x < tiles_x; ++x) {
+            min_x.emplace_back(static_cast<float>(x) * tile_extent);
+            min_y.emplace_back(static_cast<float>(y) * tile_extent);
+            max_x.emplace_back(static_cast<float>(x + 1) * tile_extent);
+            max_y.emplace_back(static_cast<float>(y + 1) * tile_extent);
+        }
+    }
+
+    visible.assign(count, 0);
+    state.assign(count, TileState::Unloaded);
+    texture.assign(count, kNoTexture);
+    color.assign(count, 0);
+    image.resize(count);
+}
+
+#if defined(TILE_LEVEL_SSE2) || defined(TILE_LEVEL_AVX)
+// Narrows two 4-lane comparison masks to eight 0/1 bytes, and reports
+// whether any of them differ from the bytes they replace.
+static auto storeFlags(std::uint8_t* out, __m128 lo, __m128 hi) -> bool {
+    const auto words = _mm_packs_epi32(_mm_castps_si128(lo), _mm_castps_si128(hi));
+    const auto bytes = _mm_and_si128(_mm_packs_epi16(words, _mm_setzero_si128()), _mm_set1_epi8(1));
+    const auto previous = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(out));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, previous)) != 0xFFFF;
+}
+#endif
+
+auto TileLevel::Cull(const Box2& bounds) -> CullResult {
+    const auto count = Size();
+    auto result = CullResult {};
+    auto i = std::size_t {0};
+
+#if defined(TILE_LEVEL_AVX)
+    const auto view_min_x = _mm256_set1_ps(bounds.min.x);
+    const auto view_min_y = _mm256_set1_ps(bounds.min.y);
+    const auto view_max_x = _mm256_set1_ps(bounds.max.x);
+    const auto view_max_y = _mm256_set1_ps(bounds.max.y);
+
+    for (; i + 8 <= count; i += 8) {
+        const auto in_x = _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(&min_x[i]), view_max_x, _CMP_LE_OQ),
+            _mm256_cmp_ps(_mm256_loadu_ps(&max_x[i]), view_min_x, _CMP_GE_OQ)
+        );
+        const auto in_y = _mm256_and_ps(
+            _mm256_cmp_ps(_mm256_loadu_ps(&min_y[i]), view_max_y, _CMP_LE_OQ),
+            _mm256_cmp_ps(_mm256_loadu_ps(&max_y[i]), view_min_y, _CMP_GE_OQ)
+        );
+        const auto mask = _mm256_and_ps(in_x, in_y);
+        result.changed |= storeFlags(&visible[i], _mm256_castps256_ps128(mask), _mm256_extractf128_ps(mask, 1));
+        result.visible += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(mask)));
+    }
+#elif defined(TILE_LEVEL_SSE2)
+    const auto view_min_x = _mm_set1_ps(bounds.min.x);
+    const auto view_min_y = _mm_set1_ps(bounds.min.y);
+    const auto view_max_x = _mm_set1_ps(bounds.max.x);
+    const auto view_max_y = _mm_set1_ps(bounds.max.y);
+
+    const auto test = [&](std::size_t first) {
+        const auto in_x = _mm_and_ps(
+            _mm_cmple_ps(_mm_loadu_ps(&min_x[first]), view_max_x),
+            _mm_cmpge_ps(_mm_loadu_ps(&max_x[first]), view_min_x)
+        );
+        const auto in_y = _mm_and_ps(
+            _mm_cmple_ps(_mm_loadu_ps(&min_y[first]), view_max_y),
+            _mm_cmpge_ps(_mm_loadu_ps(&max_y[first]), view_min_y)
+        );
+        return _mm_and_ps(in_x, in_y);
+    };
+
+    for (; i + 8 <= count; i += 8) {
+        const auto lo = test(i);
+        const auto hi = test(i + 4);
+        result.changed |= storeFlags(&visible[i], lo, hi);
+        result.visible += std::popcount(static_cast<unsigned>(_mm_movemask_ps(lo) | (_mm_movemask_ps(hi) << 4)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const auto is_visible =
+            min_x[i] <= bounds.max.x && max_x[i] >= bounds.min.x &&
+            min_y[i] <= bounds.max.y && max_y[i] >= bounds.min.y;
+        result.changed |= visible[i] != is_visible;
+        visible[i] = is_visible ? 1 : 0;
+        result.visible += visible[i];
+    }
+
+    return result;
+}
+
+auto TileLevel::MakeTile(std::size_t index) const -> Tile {
+    return {
+        .id = Id(index),
+        .position = {min_x[index], min_y[index]},
+        .size = {tile_extent_, tile_extent_},
+        .scale = std::exp2(static_cast<float>(lod_)),
+        .texture = texture[index]
+    };
+}
@@ -0,0 +1,91 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/image.h"
+#include "tile.h"
+#include "types.h"
+
+// One LOD of the pyramid stored as parallel arrays. The per-frame passes
+// stream through the packed bounds and the byte-wide flags only; texture
+// handles and decoded images sit in their own arrays and are read for the
+// few tiles that pass.
+class TileLevel {
+public:
+    struct CullResult {
+        std::size_t visible {0};
+
+        // Whether any tile's visible flag differs from the previous pass.
+        bool changed {false};
+    };
+
+    std::vector<float> min_x;
+    std::vector<float> min_y;
+    std::vector<float> max_x;
+    std::vector<float> max_y;
+
+    std::vector<std::uint8_t> visible;
+    std::vector<TileState> state;
+
+    std::vector<TextureHandle> texture;
+
+    // Packed RGBA8 of solid tiles, which are Loaded without a texture.
+    std::vector<std::uint32_t> color;
+
+    // Decoded pixels waiting for the renderer to upload them.
+    std::vector<std::shared_ptr<Image>> image;
+
+    TileLevel(unsigned lod, int tiles_x, int tiles_y, float tile_extent);
+
+    // Sets the visible flag of every tile against the view bounds.
+    // Vectorized with SSE2, or AVX where enabled.
+    auto Cull(const Box2& bounds) -> CullResult;
+
+    [[nodiscard]] auto Size() const -> std::size_t {
+        return state.size();
+    }
+
+    [[nodiscard]] auto TilesX() const -> int {
+        return static_cast<int>(tiles_x_);
+    }
+
+    [[nodiscard]] auto TilesY() const -> int {
+        return static_cast<int>(Size() / tiles_x_);
+    }
+
+    [[nodiscard]] auto Overlaps(std::size_t index, const Box2& bounds) const -> bool {
+        return min_x[index] <= bounds.max.x && max_x[index] >= bounds.min.x &&
+               min_y[index] <= bounds.max.y && max_y[index] >= bounds.min.y;
+    }
+
+    [[nodiscard]] auto Index(const TileId& id) const -> std::size_t {
+        return static_cast<std::size_t>(id.y) * tiles_x_ + id.x;
+    }
+
+    [[nodiscard]] auto Id(std::size_t index) const -> TileId {
+        return {
+            lod_,
+            static_cast<int>(index % tiles_x_),
+            static_cast<int>(index / tiles_x_)
+        };
+    }
+
+    [[nodiscard]] auto MakeTile(std::size_t index) const -> Tile;
+
+    [[nodiscard]] auto MakeRenderTile(std::size_t index) const -> RenderTile {
+        return {.model = MakeTile(index).Transform(), .texture = texture[index], .color = color[index]};
+    }
+
+private:
+    unsigned lod_ {0};
+
+    std::size_t tiles_x_ {0};
+
+    float tile_extent_ {0.0f};
+};
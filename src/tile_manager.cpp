@@ -3,30 +3,80 @@
 
 #include "tile_manager.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <format>
 #include <print>
+#include <utility>
 
-#include <imgui.h>
+// The first retry of a failed tile waits this long, and every further
+// failure doubles the wait, up to the limit.
+static constexpr auto kRetryDelay = std::chrono::milliseconds {500};
+static constexpr auto kMaxRetryDelay = std::chrono::seconds {60};
+
+static auto packKey(const TileId& id) -> std::uint64_t {
+    return (static_cast<std::uint64_t>(id.lod) << 48) |
+           (static_cast<std::uint64_t>(id.y) << 24) |
+           static_cast<std::uint64_t>(id.x);
+}
+
+static auto makeSolidImage(int width, int height, std::uint32_t rgba) -> std::shared_ptr<Image> {
+    const auto pixels = static_cast<std::size_t>(width) * height;
+    auto data = static_cast<std::uint32_t*>(std::malloc(pixels * sizeof(rgba)));
+    std::fill_n(data, pixels, rgba);
+    return std::make_shared<Image>(
+        Image::Parameters {.width = width, .height = height, .depth = 4},
+        ImageData {reinterpret_cast<unsigned char*>(data), std::free}
+    );
+}
+
+TileManager::TileManager(
+    const Dimensions& texture_dims,
+    const Dimensions& window_dims,
+    const float tile_size,
+    const int lods,
+    std::shared_ptr<TileSource> source,
+    std::shared_ptr<Loader<Image>> loader
+) :
+    TileManager(
+        texture_dims,
+        window_dims,
+        tile_size,
+        lods,
+        source,
+        std::make_shared<LoadPipeline<Image>>(loader, LoadPipeline<Image>::Config {
+            .make_reader = [source] { return source->CreateReader(); }
+        }),
+        loader
+    ) {}
 
 TileManager::TileManager(
     const Dimensions& texture_dims,
     const Dimensions& window_dims,
     const float tile_size,
-    const int lods
+    const int lods,
+    std::shared_ptr<TileSource> source,
+    std::shared_ptr<LoadPipeline<Image>> pipeline,
+    std::shared_ptr<Loader<Image>> loader
 ) :
-    loader_(ImageLoader::Create()),
+    source_(std::move(source)),
+    decoder_(std::move(loader)),
+    loader_(std::move(pipeline)),
     texture_dims_(texture_dims),
     window_dims_(window_dims),
     tile_size_(tile_size),
     max_lod_(lods - 1)
 {
-    tiles_x_per_lod_.resize(lods);
-    tiles_y_per_lod_.resize(lods);
-    tiles_.resize(lods);
+    levels_.reserve(lods);
     GenerateTiles();
+    ApplyManifest();
 }
 
 auto TileManager::Update(const OrthographicCamera& camera) -> void {
+    ProcessReady();
+
     const auto this_lod = ComputeLod(camera);
 
     if (first_frame_) {
@@ -38,50 +88,310 @@ auto TileManager::Update(const OrthographicCamera& camera) -> void {
     if (this_lod != curr_lod_) {
         prev_lod_ = curr_lod_;
         curr_lod_ = this_lod;
+        render_list_dirty_ = true;
     }
 
+    deferred_requests_ = 0;
+
+    // Only the current LOD and the coarsest one are drawn, so no other level
+    // needs its visibility refreshed.
     const auto visible_bounds = ComputeVisibleBounds(camera);
-    for (auto lod = 0; lod <= max_lod_; ++lod) {
-        for (auto& tile : tiles_[lod]) {
-            tile.visible = IsTileVisible(tile, visible_bounds);
-            if (tile.visible && lod == curr_lod_ && tile.state == TileState::Unloaded) {
-                RequestTile(tile.id);
+    render_list_dirty_ |= levels_[max_lod_].Cull(visible_bounds).changed;
+    if (curr_lod_ != max_lod_) {
+        render_list_dirty_ |= levels_[curr_lod_].Cull(visible_bounds).changed;
+    }
+
+    if (std::abs(zoom_velocity_) <= kFastZoom) {
+        RequestVisible(levels_[curr_lod_]);
+        loader_->Flush();
+        return;
+    }
+
+    // Levels a fast zoom passes through would be stale by the time their
+    // tiles decode. The coarsest level is drawn under every other, and the
+    // level a zoom out lands on has fewer tiles than the current one, so
+    // only those are fetched. The rest count as deferred, which keeps
+    // frames coming until the zoom settles and they are requested.
+    RequestVisible(levels_[max_lod_]);
+    const auto target = std::clamp(
+        static_cast<int>(std::round(static_cast<float>(curr_lod_) + zoom_velocity_ * kZoomLookahead)),
+        0,
+        static_cast<int>(max_lod_)
+    );
+    if (target > static_cast<int>(curr_lod_) && target != static_cast<int>(max_lod_)) {
+        auto& ahead = levels_[target];
+        ahead.Cull(visible_bounds);
+        RequestVisible(ahead);
+    }
+
+    const auto& level = levels_[curr_lod_];
+    for (auto i = std::size_t {0}; i < level.Size(); ++i) {
+        if (level.visible[i] && level.state[i] == TileState::Unloaded) ++deferred_requests_;
+    }
+
+    loader_->Flush();
+}
+
+auto TileManager::Update(std::span<const View> views) -> void {
+    ProcessReady();
+
+    deferred_requests_ = 0;
+    auto finest = max_lod_;
+
+    for (const auto& view : views) {
+        const auto lod = static_cast<unsigned>(ComputeLod(*view.camera, view.width));
+        finest = std::min(finest, lod);
+
+        auto& level = levels_[lod];
+        level.Cull(ComputeVisibleBounds(*view.camera));
+        RequestVisible(level);
+    }
+
+    curr_lod_ = finest;
+    render_list_dirty_ = true;
+
+    loader_->Flush();
+}
+
+auto TileManager::BuildRenderList(const View& view, std::vector<RenderTile>& list) const -> void {
+    list.clear();
+
+    const auto lod = static_cast<unsigned>(ComputeLod(*view.camera, view.width));
+    const auto bounds = ComputeVisibleBounds(*view.camera);
+    const auto append = [&](const TileLevel& level) {
+        for (auto i = std::size_t {0}; i < level.Size(); ++i) {
+            if (level.state[i] == TileState::Loaded && level.Overlaps(i, bounds)) {
+                list.emplace_back(level.MakeRenderTile(i));
             }
         }
+    };
+
+    append(levels_[max_lod_]);
+    if (lod != max_lod_) append(levels_[lod]);
+}
+
+auto TileManager::StartPreload(unsigned levels) -> void {
+    const auto first_lod = max_lod_ + 1 - std::min(levels, max_lod_ + 1);
+    for (auto lod = first_lod; lod <= max_lod_; ++lod) {
+        auto& level = levels_[lod];
+        for (auto i = std::size_t {0}; i < level.Size(); ++i) {
+            if (level.state[i] != TileState::Unloaded) continue;
+            level.state[i] = TileState::Loading;
+            preloaded_.emplace_back(Preloaded {.id = level.Id(i), .image = nullptr});
+        }
+    }
+
+    preload_next_ = 0;
+    const auto workers = std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()),
+        preloaded_.size()
+    );
+
+    for (auto i = std::size_t {0}; i < workers; ++i) {
+        preload_workers_.emplace_back([this] {
+            auto reader = source_->CreateBlockingReader();
+            const auto read = [&](const TileId& id) -> std::shared_ptr<Image> {
+                if (manifest_ != nullptr && !manifest_->Exists(id)) return nullptr;
+                const auto path = source_->Locate(ContentOf(id));
+                if (!decoder_->Validate(path)) return nullptr;
+                if (auto cached = loader_->FindCached(path)) return cached;
+
+                auto data = reader->ReadBatch(std::span {&path, 1});
+                if (!data.front()) return nullptr;
+                auto image = decoder_->Decode(data.front().value(), path);
+                if (!image) return nullptr;
+                loader_->StoreDecoded(path, image.value());
+                return image.value();
+            };
+
+            for (auto index = preload_next_++; index < preloaded_.size(); index = preload_next_++) {
+                auto& tile = preloaded_[index];
+                tile.image = read(tile.id);
+                if (tile.image || generator_ == nullptr || tile.id.lod == 0) continue;
+
+                // Built here rather than queued, so that the first frame
+                // does not wait on the generator.
+                if (auto built = generator_->GenerateNow(tile.id, *reader)) {
+                    tile.image = std::move(built.value());
+                }
+            }
+        });
     }
 }
 
-auto TileManager::GetVisibleTiles() -> std::vector<Tile*> {
-    std::vector<Tile*> visible_tiles;
+auto TileManager::FinishPreload() -> std::size_t {
+    preload_workers_.clear();
 
-    // always include low-res tiles
-    for (auto& tile : tiles_[max_lod_]) {
-        if (tile.visible && tile.state == TileState::Loaded) {
-            visible_tiles.push_back(&tile);
+    auto loaded = std::size_t {0};
+    for (auto& tile : preloaded_) {
+        auto& level = levels_[tile.id.lod];
+        const auto idx = level.Index(tile.id);
+        if (tile.image) {
+            level.image[idx] = std::move(tile.image);
+            level.state[idx] = TileState::Decoded;
+            decoded_.emplace_back(tile.id);
+            ++loaded;
+        } else if (MarkFailed(tile.id)) {
+            std::println("Failed to preload tile {}", tile.id);
         }
     }
 
-    if (curr_lod_ == max_lod_) return visible_tiles;
+    preloaded_.clear();
+    return loaded;
+}
+
+auto TileManager::TakeDecoded() -> std::vector<TileId> {
+    return std::exchange(decoded_, {});
+}
+
+auto TileManager::MarkLoaded(const TileId& id) -> void {
+    auto& level = levels_[id.lod];
+    const auto idx = level.Index(id);
+    level.state[idx] = TileState::Loaded;
+    if (id.lod == curr_lod_ || id.lod == max_lod_) render_list_dirty_ = true;
+
+    const auto group = manifest_ != nullptr && share_textures_ ? manifest_->Group(id) : std::nullopt;
+    if (!group) return;
+
+    // Tiles preloaded on their own keep their own texture.
+    auto& content = shared_[group.value()];
+    if (content.texture != kNoTexture) return;
+
+    content.texture = level.texture[idx];
+    content.users = 1;
+    content.loading = false;
+    for (const auto& waiter : std::exchange(content.waiting, {})) {
+        auto& other = levels_[waiter.lod];
+        const auto other_idx = other.Index(waiter);
+        --pending_loads_;
+        if (other.state[other_idx] != TileState::Loading) continue;
+        other.texture[other_idx] = content.texture;
+        other.state[other_idx] = TileState::Loaded;
+        ++content.users;
+        ++shared_tiles_;
+        if (waiter.lod == curr_lod_ || waiter.lod == max_lod_) render_list_dirty_ = true;
+    }
+}
+
+auto TileManager::Request(std::span<const TileId> ids) -> void {
+    ProcessReady();
 
-    for (auto& tile : tiles_[curr_lod_]) {
-        if (tile.state == TileState::Loaded) {
-            visible_tiles.push_back(&tile);
+    deferred_requests_ = 0;
+    for (const auto& id : ids) {
+        const auto& level = levels_[id.lod];
+        if (level.state[level.Index(id)] == TileState::Unloaded) {
+            if (!RequestTile(id)) ++deferred_requests_;
         }
     }
 
-    return visible_tiles;
+    loader_->Flush();
 }
 
-auto TileManager::Debug(const OrthographicCamera& camera) const -> void {
-    auto camera_scale = glm::length(glm::vec3 {camera.transform[0]});
+auto TileManager::Evict(const TileId& id) -> bool {
+    auto& level = levels_[id.lod];
+    const auto idx = level.Index(id);
+    const auto state = std::exchange(level.state[idx], TileState::Unloaded);
+    const auto texture = std::exchange(level.texture[idx], kNoTexture);
+    level.image[idx] = nullptr;
+    if (id.lod == curr_lod_ || id.lod == max_lod_) render_list_dirty_ = true;
 
-    ImGui::SetNextWindowFocus();
-    ImGui::Begin("Tile Manager");
-    ImGui::Text("Texture size: %d", static_cast<int>(texture_dims_.height));
-    ImGui::Text("Current LOD: %d", curr_lod_);
-    ImGui::Text("Camera size: %.2f", camera.Width() * camera_scale);
+    const auto group = manifest_ != nullptr && share_textures_ ? manifest_->Group(id) : std::nullopt;
+    if (!group) return true;
 
-    ImGui::End();
+    auto& content = shared_[group.value()];
+    if (state == TileState::Decoded && content.loading) {
+        // The member that was to be uploaded is gone, so nobody will
+        // hand the waiters a texture. They are requested again later.
+        for (const auto& waiter : std::exchange(content.waiting, {})) {
+            levels_[waiter.lod].state[levels_[waiter.lod].Index(waiter)] = TileState::Unloaded;
+            --pending_loads_;
+        }
+        content.loading = false;
+        return true;
+    }
+
+    if (texture == kNoTexture || texture != content.texture) return true;
+    if (--content.users > 0) {
+        --shared_tiles_;
+        return false;
+    }
+    content.texture = kNoTexture;
+    return true;
+}
+
+auto TileManager::ExpandSolidTiles() -> void {
+    for (auto& level : levels_) {
+        for (auto i = std::size_t {0}; i < level.Size(); ++i) {
+            if (level.state[i] == TileState::Loaded && level.texture[i] == kNoTexture) {
+                level.state[i] = TileState::Unloaded;
+            }
+        }
+    }
+    render_list_dirty_ = true;
+}
+
+auto TileManager::EnableGeneration(std::shared_ptr<PyramidGenerator> generator) -> void {
+    generator_ = std::move(generator);
+    if (manifest_ == nullptr) return;
+
+    // A tile the manifest lacks can be built once any of its children
+    // exists or can be built in turn, so levels are visited finest first.
+    // Absent children leave their quadrant empty.
+    for (auto lod = 1u; lod <= max_lod_; ++lod) {
+        auto& level = levels_[lod];
+        const auto& finer = levels_[lod - 1];
+        for (auto i = std::size_t {0}; i < level.Size(); ++i) {
+            if (level.state[i] != TileState::Missing) continue;
+
+            const auto id = level.Id(i);
+            auto buildable = false;
+            for (auto child = 0; child < 4 && !buildable; ++child) {
+                const auto x = id.x * 2 + child % 2;
+                const auto y = id.y * 2 + child / 2;
+                if (x >= finer.TilesX() || y >= finer.TilesY()) continue;
+                buildable = finer.state[finer.Index({lod - 1, x, y})] != TileState::Missing;
+            }
+            if (buildable) level.state[i] = TileState::Unloaded;
+        }
+    }
+    render_list_dirty_ = true;
+}
+
+auto TileManager::GetRenderList() -> std::span<const RenderTile> {
+    if (render_list_dirty_) {
+        // clear() keeps the capacity, so rebuilding stops allocating once
+        // the list has grown to the largest view seen.
+        render_list_.clear();
+
+        // always include low-res tiles
+        AppendRenderTiles(levels_[max_lod_]);
+        if (curr_lod_ != max_lod_) AppendRenderTiles(levels_[curr_lod_]);
+
+        render_list_dirty_ = false;
+    }
+    return render_list_;
+}
+
+auto TileManager::AppendRenderTiles(const TileLevel& level) -> void {
+    for (auto i = std::size_t {0}; i < level.Size(); ++i) {
+        if (level.visible[i] && level.state[i] == TileState::Loaded) {
+            render_list_.emplace_back(level.MakeRenderTile(i));
+        }
+    }
+}
+
+auto TileManager::HasPendingWork() const -> bool {
+    return pending_loads_ > 0 || deferred_requests_ > 0 || !decoded_.empty();
+}
+
+auto TileManager::GetStats() const -> Stats {
+    return {
+        .current_lod = curr_lod_,
+        .pending_loads = pending_loads_,
+        .deferred_requests = deferred_requests_,
+        .shared_tiles = shared_tiles_,
+        .pipeline = loader_->GetStats()
+    };
 }
 
 auto TileManager::GenerateTiles() -> void {
@@ -92,44 +402,117 @@ auto TileManager::GenerateTiles() -> void {
         auto tiles_x = static_cast<int>(std::ceil(lod_w / tile_size_));
         auto tiles_y = static_cast<int>(std::ceil(lod_h / tile_size_));
 
-        tiles_x_per_lod_[lod] = tiles_x;
-        tiles_y_per_lod_[lod] = tiles_y;
+        levels_.emplace_back(lod, tiles_x, tiles_y, tile_size_ * lod_scale);
+    }
+}
+
+auto TileManager::ApplyManifest() -> void {
+    const auto manifest = source_->Manifest();
+    if (manifest == nullptr) return;
 
-        tiles_[lod].reserve(tiles_x * tiles_y);
+    const auto geometry = PyramidManifest::Geometry {
+        .width = static_cast<int>(texture_dims_.width),
+        .height = static_cast<int>(texture_dims_.height),
+        .tile_size = static_cast<int>(tile_size_),
+        .lods = static_cast<int>(max_lod_ + 1)
+    };
+    if (manifest->GetGeometry() != geometry) {
+        std::println("Ignoring a manifest made for a different pyramid");
+        return;
+    }
+    manifest_ = manifest;
+    shared_.resize(manifest_->GroupCount());
 
-        for (auto y = 0; y < tiles_y; ++y) {
-            for (auto x = 0; x < tiles_x; ++x) {
-                auto id = TileId {lod, x, y};
+    for (auto& level : levels_) {
+        for (auto i = std::size_t {0}; i < level.Size(); ++i) {
+            const auto id = level.Id(i);
+            if (!manifest_->Exists(id)) {
+                level.state[i] = TileState::Missing;
+            } else if (const auto color = manifest_->SolidColor(id)) {
+                level.state[i] = TileState::Loaded;
+                level.color[i] = color.value();
+            }
+        }
+    }
+}
 
-                auto size = glm::vec2 {
-                    tile_size_ * lod_scale,
-                    tile_size_ * lod_scale,
-                };
+auto TileManager::RequestShared(const TileId& id, std::uint32_t group) -> bool {
+    auto& level = levels_[id.lod];
+    const auto idx = level.Index(id);
+    auto& content = shared_[group];
 
-                auto position = glm::vec2 {
-                    static_cast<float>(x) * size.x,
-                    static_cast<float>(y) * size.y
-                };
+    if (content.texture != kNoTexture) {
+        level.texture[idx] = content.texture;
+        level.state[idx] = TileState::Loaded;
+        ++content.users;
+        ++shared_tiles_;
+        if (id.lod == curr_lod_ || id.lod == max_lod_) render_list_dirty_ = true;
+        return true;
+    }
 
-                tiles_[lod].emplace_back(id, position, size, lod_scale);
+    if (!content.loading) {
+        if (!LoadShared(group)) return false;
+        content.loading = true;
+    }
+    content.waiting.emplace_back(id);
+    level.state[idx] = TileState::Loading;
+    ++pending_loads_;
+    return true;
+}
+
+auto TileManager::LoadShared(std::uint32_t group) -> bool {
+    if (request_quota_ == 0) return false;
+
+    const auto path = source_->Locate(manifest_->GroupSource(group));
+    const auto queued = loader_->LoadAsync(path, [this, group](auto result) {
+        auto& content = shared_[group];
+        if (!content.loading || content.waiting.empty()) return;
+
+        if (!result) {
+            auto first_failure = false;
+            for (const auto& waiter : std::exchange(content.waiting, {})) {
+                first_failure |= MarkFailed(waiter);
+                --pending_loads_;
             }
+            content.loading = false;
+            if (first_failure) std::println("Failed to load tile group {}", group);
+            return;
         }
-    }
+
+        // The others keep waiting, and counting as pending loads, until
+        // the first one has a texture.
+        const auto first = content.waiting.front();
+        content.waiting.erase(content.waiting.begin());
+        auto& level = levels_[first.lod];
+        const auto idx = level.Index(first);
+        level.image[idx] = result.value();
+        level.state[idx] = TileState::Decoded;
+        decoded_.emplace_back(first);
+        --pending_loads_;
+    });
+
+    if (queued) --request_quota_;
+    return queued;
+}
+
+auto TileManager::ContentOf(const TileId& id) const -> TileId {
+    if (manifest_ == nullptr) return id;
+    const auto group = manifest_->Group(id);
+    return group ? manifest_->GroupSource(group.value()) : id;
 }
 
 auto TileManager::ComputeLod(const OrthographicCamera& camera) const -> int {
+    return ComputeLod(camera, window_dims_.width);
+}
+
+auto TileManager::ComputeLod(const OrthographicCamera& camera, float viewport_width) const -> int {
     auto scale_x = glm::length(glm::vec3{camera.transform[0]});
     auto virtual_width = camera.Width() * scale_x;
-    auto world_units_per_pixel = virtual_width / window_dims_.width;
+    auto world_units_per_pixel = virtual_width / viewport_width;
     auto lod = std::log2(world_units_per_pixel);
     return std::clamp(static_cast<int>(lod), 0, static_cast<int>(max_lod_));
 }
 
-auto TileManager::IsTileVisible(const Tile& tile, const Box2& visible_bounds) const -> bool {
-    auto bounds = Box2 {.min = tile.position, .max = tile.position + tile.size};
-    return visible_bounds.Intersects(bounds);
-}
-
 auto TileManager::ComputeVisibleBounds(const OrthographicCamera& camera) const -> Box2 {
     auto inv_vp = glm::inverse(camera.projection * camera.View());
     auto top_left = inv_vp * glm::vec4(-1.0f, 1.0f, 0.0f, 1.0f);
@@ -140,23 +523,128 @@ auto TileManager::ComputeVisibleBounds(const OrthographicCamera& camera) const -
     );
 }
 
-auto TileManager::GetTileIndex(const TileId& id) const -> int {
-    return id.y * tiles_x_per_lod_[id.lod] + id.x;
-}
+auto TileManager::RequestTile(const TileId& id) -> bool {
+    if (request_quota_ == 0) return false;
+
+    const auto idx = levels_[id.lod].Index(id);
+
+    // Tiles the manifest lacks are built without reading the source first.
+    if (manifest_ != nullptr && !manifest_->Exists(id)) {
+        if (generator_ == nullptr || id.lod == 0) return false;
+        const auto generating = generator_->Generate(id, [this, id](auto generated) {
+            OnTileLoaded(id, std::move(generated));
+        });
+        if (generating) {
+            levels_[id.lod].state[idx] = TileState::Loading;
+            ++pending_loads_;
+            --request_quota_;
+        }
+        return generating;
+    }
+
+    // Solid tiles are filled in place, without costing the pipeline a slot.
+    if (manifest_ != nullptr) {
+        if (const auto color = manifest_->SolidColor(id)) {
+            const auto lod_tile = tile_size_ * static_cast<float>(1 << id.lod);
+            const auto width = std::min(tile_size_, (texture_dims_.width - id.x * lod_tile) / (1 << id.lod));
+            const auto height = std::min(tile_size_, (texture_dims_.height - id.y * lod_tile) / (1 << id.lod));
+            auto& level = levels_[id.lod];
+            level.image[idx] = makeSolidImage(
+                static_cast<int>(std::ceil(width)),
+                static_cast<int>(std::ceil(height)),
+                color.value()
+            );
+            level.state[idx] = TileState::Decoded;
+            decoded_.emplace_back(id);
+            return true;
+        }
+        if (const auto group = manifest_->Group(id); group && share_textures_) {
+            return RequestShared(id, group.value());
+        }
+    }
+
+    const auto path = source_->Locate(ContentOf(id));
+
+    // Results are delivered by ProcessReady() on this thread, so tile state
+    // is only ever touched from the render loop.
+    const auto queued = loader_->LoadAsync(path, [this, id](auto result) {
+        if (!result && generator_ != nullptr && id.lod > 0) {
+            const auto generating = generator_->Generate(id, [this, id](auto generated) {
+                OnTileLoaded(id, std::move(generated));
+            });
+            if (generating) return;
+
+            // The generator is busy; the tile is requested again later.
+            MarkFailed(id);
+            --pending_loads_;
+            return;
+        }
+        OnTileLoaded(id, std::move(result));
+    });
 
-auto TileManager::RequestTile(const TileId& id) -> void {
-    const auto idx = GetTileIndex(id);
-    const auto path = std::format("assets/tiles/{}.png", id);
+    if (queued) {
+        levels_[id.lod].state[idx] = TileState::Loading;
+        ++pending_loads_;
+        --request_quota_;
+    }
+    return queued;
+}
 
-    tiles_[id.lod][idx].state = TileState::Loading;
-     loader_->LoadAsync(path, [this, id, idx](auto result) {
-        if (result) {
-            tiles_[id.lod][idx].texture.SetImage(result.value());
-            tiles_[id.lod][idx].state = TileState::Loaded;
-            std::println("Loaded tile {}", id);
-        } else {
-            tiles_[id.lod][idx].state = TileState::Unloaded;
-            std::println("Failed to load tile {}", id.lod);
+auto TileManager::RequestVisible(const TileLevel& level) -> void {
+    for (auto i = std::size_t {0}; i < level.Size(); ++i) {
+        if (level.visible[i] && level.state[i] == TileState::Unloaded) {
+            if (!RequestTile(level.Id(i))) ++deferred_requests_;
         }
+    }
+}
+
+auto TileManager::OnTileLoaded(const TileId& id, LoaderResult<Image> result) -> void {
+    auto& level = levels_[id.lod];
+    const auto idx = level.Index(id);
+    if (result) {
+        level.image[idx] = result.value();
+        level.state[idx] = TileState::Decoded;
+        decoded_.emplace_back(id);
+    } else if (IsNotFound(result.error())) {
+        // Neither the source nor the generator has anything for it.
+        level.state[idx] = TileState::Missing;
+    } else if (MarkFailed(id)) {
+        std::println("Failed to load tile {}", id);
+    }
+    --pending_loads_;
+}
+
+auto TileManager::MarkFailed(const TileId& id) -> bool {
+    auto& level = levels_[id.lod];
+    level.state[level.Index(id)] = TileState::Error;
+
+    auto& failure = failures_[packKey(id)];
+    failure.id = id;
+    const auto delay = std::min<std::chrono::steady_clock::duration>(
+        kRetryDelay * (1 << std::min(failure.attempts, 16)),
+        kMaxRetryDelay
+    );
+    failure.retry_at = std::chrono::steady_clock::now() + delay;
+    return failure.attempts++ == 0;
+}
+
+auto TileManager::RetryFailed() -> void {
+    if (failures_.empty()) return;
+
+    // Tiles that have since loaded start over; the rest keep their count
+    // until they do, so a tile that keeps failing is tried less and less.
+    const auto now = std::chrono::steady_clock::now();
+    std::erase_if(failures_, [&](const auto& entry) {
+        const auto& failure = entry.second;
+        auto& level = levels_[failure.id.lod];
+        auto& state = level.state[level.Index(failure.id)];
+        if (state == TileState::Error && failure.retry_at <= now) state = TileState::Unloaded;
+        return state == TileState::Decoded || state == TileState::Loaded;
     });
+}
+
+auto TileManager::ProcessReady() -> void {
+    loader_->ProcessReady();
+    if (generator_ != nullptr) generator_->ProcessReady();
+    RetryFailed();
 }
\ No newline at end of file
@@ -3,37 +3,218 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <span>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <glm/vec2.hpp>
 
 #include "core/orthographic_camera.h"
 #include "loaders/image_loader.h"
+#include "loaders/load_pipeline.h"
+#include "loaders/pyramid_generator.h"
+#include "sources/tile_source.h"
 #include "tile.h"
+#include "tile_level.h"
 #include "types.h"
 
+// Decides which tiles are visible at which LOD and streams them in. It has
+// no graphics dependency: decoded tiles are handed to the renderer through
+// TakeDecoded(), and the renderer marks them Loaded once they are on the GPU.
 class TileManager {
 public:
+    // Zoom speed, in LODs per second, above which requests wait for the
+    // zoom to settle.
+    static constexpr float kFastZoom {1.5f};
+
+    // How far ahead, in seconds, a fast zoom out is followed to predict the
+    // LOD it lands on.
+    static constexpr float kZoomLookahead {0.25f};
+
+    struct Stats {
+        unsigned current_lod {0};
+        int pending_loads {0};
+        int deferred_requests {0};
+
+        // Loaded tiles drawing another tile's texture.
+        int shared_tiles {0};
+
+        LoadPipeline<Image>::Stats pipeline {};
+    };
+
+    // A camera and the width, in window coordinates, of the viewport it
+    // draws into.
+    struct View {
+        const OrthographicCamera* camera {nullptr};
+        float width {0.0f};
+    };
+
     TileManager(
         const Dimensions& image_dims,
         const Dimensions& window_dims,
         const float tile_size,
-        const int lods
+        const int lods,
+        std::shared_ptr<TileSource> source,
+        std::shared_ptr<Loader<Image>> loader = ImageLoader::Create()
+    );
+
+    // Streams through a pipeline shared with other managers, such as the
+    // layers of a LayerStack, instead of starting workers of its own. The
+    // pipeline's readers must be able to read this source's paths.
+    TileManager(
+        const Dimensions& image_dims,
+        const Dimensions& window_dims,
+        const float tile_size,
+        const int lods,
+        std::shared_ptr<TileSource> source,
+        std::shared_ptr<LoadPipeline<Image>> pipeline,
+        std::shared_ptr<Loader<Image>> loader = ImageLoader::Create()
     );
 
     auto Update(const OrthographicCamera& camera) -> void;
 
-    auto GetVisibleTiles() -> std::vector<Tile*>;
+    // Streams the union of what several views show, each at its own LOD. A
+    // tile seen by more than one view is requested and stored once. Used in
+    // place of Update(camera); each view then builds its own render list.
+    auto Update(std::span<const View> views) -> void;
+
+    // Loaded tiles the view shows, coarsest LOD first.
+    auto BuildRenderList(const View& view, std::vector<RenderTile>& list) const -> void;
+
+    // Starts loading the coarsest `levels` LODs on every core, outside the
+    // load pipeline, so that the first frame can show the whole image.
+    // Meant to overlap with window and context creation; nothing else may
+    // touch the manager until FinishPreload().
+    auto StartPreload(unsigned levels = 1) -> void;
+
+    // Waits for the preload and hands its tiles to the renderer like any
+    // other decoded tile. Returns how many were loaded.
+    auto FinishPreload() -> std::size_t;
+
+    // Tiles decoded since the last call, in completion order. Their pixels
+    // wait in TileLevel::image until the renderer takes them.
+    [[nodiscard]] auto TakeDecoded() -> std::vector<TileId>;
+
+    // Marks a tile as drawable once the renderer has its texture.
+    auto MarkLoaded(const TileId& id) -> void;
+
+    // Requests exactly the given tiles instead of the ones the camera covers.
+    // Used in place of Update() by renderers that know which tiles they
+    // sample, such as VirtualTexture.
+    auto Request(std::span<const TileId> ids) -> void;
+
+    // Caps how many tiles later Update() and Request() calls may queue, so
+    // that managers sharing a pipeline can split its free capacity.
+    auto SetRequestQuota(std::size_t quota) -> void {
+        request_quota_ = quota;
+    }
+
+    // Zoom speed in LODs per second, positive towards coarser levels, as
+    // ZoomPanCamera reports it. Above kFastZoom, Update(camera) holds back
+    // the current LOD's tiles, which would be stale by the time they
+    // decode, and fetches only the coarsest level and the one the zoom is
+    // heading out to. The held tiles are requested once the zoom settles.
+    auto SetZoomVelocity(float lods_per_second) -> void {
+        zoom_velocity_ = lods_per_second;
+    }
+
+    // Drops a loaded tile so that it can be requested again. Returns false
+    // while other tiles still share its texture, which must then be kept.
+    auto Evict(const TileId& id) -> bool;
+
+    // Solid tiles start out Loaded and are drawn as flat quads. This turns
+    // them back into requests, answered with an image of their colour and
+    // no file access, for renderers that can only draw textures.
+    auto ExpandSolidTiles() -> void;
+
+    // Tiles with identical content share one load, one decode and one
+    // texture, reference counted here. Renderers that own a texture per
+    // tile turn this off; duplicates then still read the group's one file.
+    auto DisableTextureSharing() -> void {
+        share_textures_ = false;
+    }
+
+    // Tiles above LOD 0 that the source fails to load, or that the manifest
+    // lacks but whose children it has, are built from the level below
+    // instead, preloaded ones included. Several managers may share one
+    // generator. Call before StartPreload().
+    auto EnableGeneration(std::shared_ptr<PyramidGenerator> generator) -> void;
+
+    // Loaded, visible tiles, coarsest LOD first. The list lives across frames
+    // and is rebuilt in place only after the LOD, visibility or a tile's state
+    // changed, so a steady view costs no allocations and no matrix math.
+    auto GetRenderList() -> std::span<const RenderTile>;
+
+    auto GetLevel(unsigned lod) -> TileLevel& {
+        return levels_[lod];
+    }
+
+    [[nodiscard]] auto GetLevel(unsigned lod) const -> const TileLevel& {
+        return levels_[lod];
+    }
+
+    [[nodiscard]] auto HasPendingWork() const -> bool;
+
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+    [[nodiscard]] auto TextureDims() const -> const Dimensions& {
+        return texture_dims_;
+    }
 
-    auto Debug(const OrthographicCamera& camera) const -> void;
+    [[nodiscard]] auto CurrentLod() const -> unsigned {
+        return curr_lod_;
+    }
+
+    [[nodiscard]] auto LodCount() const -> unsigned {
+        return max_lod_ + 1;
+    }
+
+    [[nodiscard]] auto TileSize() const -> float {
+        return tile_size_;
+    }
+
+    [[nodiscard]] auto ComputeLod(const OrthographicCamera& camera) const -> int;
+
+    [[nodiscard]] auto ComputeLod(const OrthographicCamera& camera, float viewport_width) const -> int;
+
+    [[nodiscard]] auto ComputeVisibleBounds(const OrthographicCamera& camera) const -> Box2;
 
 private:
-    std::vector<int> tiles_x_per_lod_;
-    std::vector<int> tiles_y_per_lod_;
-    std::vector<std::vector<Tile>> tiles_;
+    std::vector<TileLevel> levels_;
+
+    std::shared_ptr<TileSource> source_;
+
+    std::shared_ptr<Loader<Image>> decoder_;
+
+    std::shared_ptr<LoadPipeline<Image>> loader_;
 
-    std::shared_ptr<ImageLoader> loader_;
+    std::shared_ptr<PyramidGenerator> generator_;
+
+    // The source's manifest, if it matches the pyramid's geometry.
+    const PyramidManifest* manifest_ {nullptr};
+
+    // One per manifest group. While the group's content loads, requests
+    // for its members wait here instead of loading it again; the first
+    // member is uploaded and the rest adopt its texture in MarkLoaded().
+    struct SharedContent {
+        TextureHandle texture {kNoTexture};
+        int users {0};
+        bool loading {false};
+        std::vector<TileId> waiting;
+    };
+
+    std::vector<SharedContent> shared_;
+
+    bool share_textures_ {true};
+
+    int shared_tiles_ {0};
 
     Dimensions texture_dims_;
     Dimensions window_dims_;
@@ -48,15 +229,75 @@ private:
 
     bool first_frame_ {true};
 
+    // Loads in flight, and visible tiles the pipeline had no room for this
+    // frame. Either one means another frame is needed to show the result.
+    int pending_loads_ {0};
+    int deferred_requests_ {0};
+
+    std::size_t request_quota_ {std::numeric_limits<std::size_t>::max()};
+
+    // Tiles in the Error state, by packed id. Each one goes back to
+    // Unloaded, to be requested again, once its retry time passes; the
+    // wait doubles with every failure.
+    struct Failure {
+        TileId id;
+        int attempts {0};
+        std::chrono::steady_clock::time_point retry_at;
+    };
+
+    std::unordered_map<std::uint64_t, Failure> failures_;
+
+    float zoom_velocity_ {0.0f};
+
+    std::vector<TileId> decoded_;
+
+    std::vector<RenderTile> render_list_;
+
+    bool render_list_dirty_ {true};
+
+    struct Preloaded {
+        TileId id;
+        std::shared_ptr<Image> image;
+    };
+
+    // Each preload worker claims tiles by index and fills in their image.
+    std::vector<Preloaded> preloaded_;
+    std::atomic<std::size_t> preload_next_ {0};
+
+    // Declared last so that the workers are joined before what they use.
+    std::vector<std::jthread> preload_workers_;
+
     auto GenerateTiles() -> void;
 
-    auto ComputeLod(const OrthographicCamera& camera) const -> int;
+    // Marks the tiles the manifest records as missing or solid, so that
+    // neither kind is ever read from the source.
+    auto ApplyManifest() -> void;
+
+    auto RequestTile(const TileId& id) -> bool;
+
+    // Requests the level's visible, unloaded tiles, counting the ones the
+    // pipeline had no room for as deferred.
+    auto RequestVisible(const TileLevel& level) -> void;
+
+    auto OnTileLoaded(const TileId& id, LoaderResult<Image> result) -> void;
+
+    // Puts the tile in the Error state until its next retry. Returns true
+    // the first time the tile fails, so that it is reported once.
+    auto MarkFailed(const TileId& id) -> bool;
+
+    auto RetryFailed() -> void;
+
+    // Collects finished loads and generated tiles.
+    auto ProcessReady() -> void;
 
-    auto IsTileVisible(const Tile& tile, const Box2& visible_bounds) const -> bool;
+    auto RequestShared(const TileId& id, std::uint32_t group) -> bool;
 
-    auto ComputeVisibleBounds(const OrthographicCamera& camera) const -> Box2;
+    // The tile whose file holds this tile's content.
+    [[nodiscard]] auto ContentOf(const TileId& id) const -> TileId;
 
-    auto GetTileIndex(const TileId& id) const -> int;
+    // Loads the content of a group and hands it to the first member that
+    // waits for it.
+    auto LoadShared(std::uint32_t group) -> bool;
 
-    auto RequestTile(const TileId& id) -> void;
-};
\ No newline at end of file
+    auto AppendRenderTiles(const TileLevel& level) -> void;
+};
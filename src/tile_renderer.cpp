@@ -0,0 +1,218 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "tile_renderer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <glm/gtc/packing.hpp>
+#include <imgui.h>
+
+#include "core/uniform_blocks.h"
+
+#include "shaders/headers/tile_frag.h"
+#include "shaders/headers/tile_vert.h"
+
+// Sampled on the texture unit after the tiles'.
+static constexpr int kLutUnit {1};
+
+static constexpr int kMaxStencilRef {255};
+
+static constexpr std::array kColorMaps {"None", "Hot", "Jet"};
+
+static auto alignUp(std::size_t size, std::size_t alignment) -> std::size_t {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+static auto makeColorMap(int map) -> std::vector<std::uint8_t> {
+    if (map == 0) return {};
+
+    constexpr auto kEntries = 256;
+    const auto channel = [](float value) {
+        return static_cast<std::uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    };
+
+    auto rgba = std::vector<std::uint8_t> {};
+    rgba.reserve(kEntries * 4);
+    for (auto i = 0; i < kEntries; ++i) {
+        const auto t = static_cast<float>(i) / (kEntries - 1);
+        if (map == 1) {
+            rgba.insert(rgba.end(), {channel(3.0f * t), channel(3.0f * t - 1.0f), channel(3.0f * t - 2.0f), 255});
+        } else {
+            rgba.insert(rgba.end(), {
+                channel(1.5f - std::abs(4.0f * t - 3.0f)),
+                channel(1.5f - std::abs(4.0f * t - 2.0f)),
+                channel(1.5f - std::abs(4.0f * t - 1.0f)),
+                255
+            });
+        }
+    }
+    return rgba;
+}
+
+TileRenderer::TileRenderer(float tile_size) :
+    geometry_({
+        .width = tile_size,
+        .height = tile_size,
+        .width_segments = 1,
+        .height_segments = 1
+    }),
+    shader_({
+        {ShaderType::kVertexShader, _SHADER_tile_vert},
+        {ShaderType::kFragmentShader, _SHADER_tile_frag}
+    }),
+    uniforms_(GL_UNIFORM_BUFFER, 256 * 1024),
+    alignment_(StreamBuffer::UniformAlignment())
+{
+    shader_.BindUniformBlock("Camera", kCameraBlockBinding);
+    shader_.BindUniformBlock("Tile", kTileBlockBinding);
+
+    shader_.SetUniform("u_TextureMap", 0);
+    shader_.SetUniform("u_Lut", kLutUnit);
+}
+
+auto TileRenderer::SetLut(std::span<const std::uint8_t> rgba) -> void {
+    lut_size_ = static_cast<int>(rgba.size() / 4);
+    if (lut_size_ == 0) return;
+
+    if (lut_ == 0) {
+        glGenTextures(1, &lut_);
+        glBindTexture(GL_TEXTURE_1D, lut_);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_1D, lut_);
+    glTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA8, lut_size_, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+}
+
+auto TileRenderer::Debug() -> void {
+    ImGui::Begin("Display");
+    ImGui::SliderFloat("Level", &display_.level, 0.0f, 1.0f);
+    ImGui::SliderFloat("Window", &display_.window, 0.001f, 1.0f);
+    ImGui::SliderFloat("Gamma", &display_.gamma, 0.1f, 4.0f);
+    if (ImGui::Combo("Color map", &color_map_, kColorMaps.data(), static_cast<int>(kColorMaps.size()))) {
+        SetLut(makeColorMap(color_map_));
+    }
+    ImGui::End();
+}
+
+auto TileRenderer::Draw(
+    const OrthographicCamera& camera,
+    std::span<const RenderTile> tiles,
+    TileTextures& textures,
+    const LayerStyle& style
+) -> void {
+    const auto own_frame = !in_frame_;
+    if (own_frame) BeginFrame();
+
+    // Every tile block starts on a binding boundary.
+    const auto stride = alignUp(sizeof(TileBlock), alignment_);
+    frame_bytes_ += alignUp(sizeof(CameraBlock), alignment_) + stride * tiles.size();
+
+    const auto camera_data = CameraBlock {.projection = camera.projection, .view = camera.View()};
+    auto camera_block = uniforms_.Push(camera_data, alignment_);
+    auto tile_blocks = uniforms_.Allocate(stride * tiles.size(), alignment_);
+    if (camera_block.data == nullptr || tile_blocks.data == nullptr) {
+        // This frame outgrew the region, so the draw moves on to a new one
+        // large enough for the whole frame.
+        uniforms_.EndFrame();
+        uniforms_.BeginFrame(frame_bytes_);
+        camera_block = uniforms_.Push(camera_data, alignment_);
+        tile_blocks = uniforms_.Allocate(stride * tiles.size(), alignment_);
+    }
+    for (auto i = std::size_t {0}; i < tiles.size(); ++i) {
+        const auto block = TileBlock {
+            .model = tiles[i].model,
+            .color = glm::unpackUnorm4x8(tiles[i].color),
+            .solid = tiles[i].texture == kNoTexture ? 1 : 0,
+            .padding = {}
+        };
+        std::memcpy(static_cast<unsigned char*>(tile_blocks.data) + i * stride, &block, sizeof(TileBlock));
+    }
+    uniforms_.Flush();
+
+    const auto half_window = std::max(display_.window, 1e-4f) * 0.5f;
+    shader_.SetUniform("u_Window", glm::vec2 {display_.level - half_window, display_.level + half_window});
+    shader_.SetUniform("u_Gamma", std::max(display_.gamma, 1e-3f));
+    shader_.SetUniform("u_LutSize", lut_size_);
+    shader_.SetUniform("u_Opacity", std::clamp(style.opacity, 0.0f, 1.0f));
+    if (lut_size_ > 0) {
+        glActiveTexture(GL_TEXTURE0 + kLutUnit);
+        glBindTexture(GL_TEXTURE_1D, lut_);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    glBindBufferRange(
+        GL_UNIFORM_BUFFER,
+        kCameraBlockBinding,
+        uniforms_.Id(),
+        static_cast<GLintptr>(camera_block.offset),
+        sizeof(CameraBlock)
+    );
+
+    // Opaque layers overdraw coarse tiles with fine ones. Translucent ones
+    // go the other way and let the stencil keep what is already covered.
+    const auto opaque = style.IsOpaque();
+    if (!opaque) BeginTranslucent(style);
+
+    for (auto n = std::size_t {0}; n < tiles.size(); ++n) {
+        const auto i = opaque ? n : tiles.size() - 1 - n;
+        textures.Bind(tiles[i].texture);
+        glBindBufferRange(
+            GL_UNIFORM_BUFFER,
+            kTileBlockBinding,
+            uniforms_.Id(),
+            static_cast<GLintptr>(tile_blocks.offset + i * stride),
+            sizeof(TileBlock)
+        );
+        geometry_.Draw(shader_);
+    }
+
+    if (!opaque) {
+        glDisable(GL_STENCIL_TEST);
+        glDisable(GL_BLEND);
+    }
+
+    if (own_frame) EndFrame();
+}
+
+auto TileRenderer::BeginFrame() -> void {
+    // Sized by what the previous frame needed, which a steady view repeats.
+    uniforms_.BeginFrame(frame_bytes_);
+    frame_bytes_ = 0;
+    in_frame_ = true;
+}
+
+auto TileRenderer::EndFrame() -> void {
+    uniforms_.EndFrame();
+    in_frame_ = false;
+}
+
+auto TileRenderer::BeginTranslucent(const LayerStyle& style) -> void {
+    if (++stencil_ref_ > kMaxStencilRef) {
+        glStencilMask(0xFF);
+        glClearStencil(0);
+        glClear(GL_STENCIL_BUFFER_BIT);
+        stencil_ref_ = 1;
+    }
+    glEnable(GL_STENCIL_TEST);
+    glStencilMask(0xFF);
+    glStencilFunc(GL_NOTEQUAL, stencil_ref_, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+    glEnable(GL_BLEND);
+    switch (style.blend) {
+        case BlendMode::kNormal: glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); break;
+        case BlendMode::kAdditive: glBlendFunc(GL_ONE, GL_ONE); break;
+        case BlendMode::kMultiply: glBlendFunc(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA); break;
+    }
+}
+
+TileRenderer::~TileRenderer() {
+    if (lut_ != 0) glDeleteTextures(1, &lut_);
+}
@@ -0,0 +1,116 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "core/orthographic_camera.h"
+#include "core/shaders.h"
+#include "core/stream_buffer.h"
+#include "geometries/plane_geometry.h"
+#include "tile.h"
+#include "tile_textures.h"
+
+// How samples map to screen color. Values are normalized, so for 16-bit
+// tiles 1.0 is 65535.
+struct DisplaySettings {
+    // Window/level: samples in [level - window / 2, level + window / 2]
+    // stretch over the full output range and the rest clamp.
+    float level {0.5f};
+    float window {1.0f};
+
+    float gamma {1.0f};
+};
+
+enum class BlendMode {
+    kNormal,
+    kAdditive,
+    kMultiply
+};
+
+// How a layer composites over the layers drawn before it.
+struct LayerStyle {
+    float opacity {1.0f};
+    BlendMode blend {BlendMode::kNormal};
+
+    [[nodiscard]] auto IsOpaque() const -> bool {
+        return opacity >= 1.0f && blend == BlendMode::kNormal;
+    }
+};
+
+// Draws the render list one tile at a time. The camera and every tile's
+// model matrix are written into a streaming uniform buffer before the
+// first draw, so each draw only binds a range of it.
+//
+// Window/level, gamma and an optional color lookup table are uniforms of the
+// tile shader, so changing them costs nothing but the next frame.
+//
+// Translucent layers are drawn finest LOD first through the stencil buffer,
+// so that every pixel blends exactly once even where a coarse tile lies
+// under a fine one.
+class TileRenderer {
+public:
+    explicit TileRenderer(float tile_size);
+
+    TileRenderer(const TileRenderer&) = delete;
+    TileRenderer& operator=(const TileRenderer&) = delete;
+
+    // Brackets the Draw() calls of one frame, such as one per layer or
+    // viewport, so that they share a region of the uniform ring instead of
+    // each taking one. A Draw() outside them is a frame of its own.
+    auto BeginFrame() -> void;
+    auto EndFrame() -> void;
+
+    auto Draw(
+        const OrthographicCamera& camera,
+        std::span<const RenderTile> tiles,
+        TileTextures& textures,
+        const LayerStyle& style = {}
+    ) -> void;
+
+    auto SetDisplay(const DisplaySettings& display) -> void {
+        display_ = display;
+    }
+
+    [[nodiscard]] auto Display() const -> const DisplaySettings& {
+        return display_;
+    }
+
+    // Maps the first channel through RGBA8 entries, evenly spaced over
+    // [0, 1]. An empty table turns the lookup off.
+    auto SetLut(std::span<const std::uint8_t> rgba) -> void;
+
+    auto Debug() -> void;
+
+    ~TileRenderer();
+
+private:
+    PlaneGeometry geometry_;
+
+    Shaders shader_;
+
+    StreamBuffer uniforms_;
+
+    std::size_t alignment_ {0};
+
+    // Uniform bytes the Draw() calls of the current frame asked for.
+    std::size_t frame_bytes_ {0};
+    bool in_frame_ {false};
+
+    DisplaySettings display_;
+
+    unsigned int lut_ {0};
+    int lut_size_ {0};
+
+    // The built-in table picked in the debug window.
+    int color_map_ {0};
+
+    // Stencil value of the last translucent layer. Each one gets a new value,
+    // and the buffer is cleared when they run out, starting with the first.
+    int stencil_ref_ {255};
+
+    auto BeginTranslucent(const LayerStyle& style) -> void;
+};
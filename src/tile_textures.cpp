@@ -0,0 +1,187 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "tile_textures.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <functional>
+#include <print>
+#include <utility>
+
+#include <glm/glm.hpp>
+#include <imgui.h>
+
+#include "core/buffer_pool.h"
+
+auto TileTextures::SetUploadThread(UploadThread* uploader) -> void {
+    uploader_ = uploader;
+}
+
+auto TileTextures::Update(const UploadBudget& budget) -> void {
+    if (uploader_ != nullptr) uploader_->ProcessCompleted();
+
+    for (const auto& id : tiles_->TakeDecoded()) {
+        auto& level = tiles_->GetLevel(id.lod);
+        auto image = std::move(level.image[level.Index(id)]);
+        const auto handle = GetHandle(id);
+        std::println("Loaded tile {}", id);
+
+        const auto submitted = uploader_ != nullptr &&
+            uploader_->Submit(image, [this, id, handle, bytes = image->Bytes()](unsigned int texture_id) {
+                textures_[handle - 1].Adopt(texture_id);
+                SetResident(handle, bytes);
+                tiles_->MarkLoaded(id);
+            });
+
+        if (!submitted) {
+            textures_[handle - 1].SetImage(std::move(image));
+            upload_queue_.emplace_back(id);
+        }
+    }
+
+    ProcessUploads(budget);
+}
+
+auto TileTextures::ProcessUploads(const UploadBudget& budget) -> void {
+    auto uploads = 0;
+    auto mipmaps = 0;
+    auto bytes = std::size_t {0};
+
+    // The first upload of a frame always goes through, so a tile larger
+    // than the byte budget still makes progress.
+    while (!upload_queue_.empty() && uploads < budget.uploads) {
+        const auto id = upload_queue_.front();
+        const auto& level = tiles_->GetLevel(id.lod);
+        const auto handle = GetHandle(id);
+        auto& texture = textures_[handle - 1];
+        const auto pending = texture.PendingBytes();
+        if (uploads > 0 && bytes + pending > budget.bytes) break;
+        upload_queue_.pop_front();
+        if (level.state[level.Index(id)] != TileState::Decoded) continue;
+
+        // Mipmaps are generated inline only while this frame's budget
+        // allows it and no older tile waits for them; otherwise the tile
+        // shows its base level until a later frame.
+        const auto with_mipmaps = mipmap_queue_.empty() && mipmaps < budget.mipmaps;
+        const auto uploaded = texture.Upload(with_mipmaps);
+        bytes += uploaded;
+        SetResident(handle, uploaded);
+        tiles_->MarkLoaded(id);
+        if (with_mipmaps) ++mipmaps;
+        else mipmap_queue_.emplace_back(id);
+        ++uploads;
+    }
+
+    while (mipmaps < budget.mipmaps && !mipmap_queue_.empty()) {
+        const auto id = mipmap_queue_.front();
+        mipmap_queue_.pop_front();
+
+        // Skips tiles evicted while they waited.
+        const auto& level = tiles_->GetLevel(id.lod);
+        if (level.state[level.Index(id)] != TileState::Loaded) continue;
+        textures_[GetHandle(id) - 1].GenerateMipmaps();
+        ++mipmaps;
+    }
+}
+
+auto TileTextures::SetResident(TextureHandle handle, std::size_t bytes) -> void {
+    resident_bytes_ = resident_bytes_ - sizes_[handle - 1] + bytes;
+    sizes_[handle - 1] = bytes;
+}
+
+auto TileTextures::Evict(std::size_t bytes) -> std::size_t {
+    const auto current = static_cast<int>(tiles_->CurrentLod());
+    const auto coarsest = static_cast<int>(tiles_->LodCount()) - 1;
+
+    auto lods = std::vector<int> {};
+    for (auto lod = 0; lod < coarsest; ++lod) lods.emplace_back(lod);
+    std::ranges::stable_sort(lods, std::greater {}, [&](int lod) { return std::abs(lod - current); });
+
+    auto freed = std::size_t {0};
+    for (const auto lod : lods) {
+        auto& level = tiles_->GetLevel(static_cast<unsigned>(lod));
+        for (auto i = std::size_t {0}; i < level.Size() && freed < bytes; ++i) {
+            if (level.state[i] != TileState::Loaded || level.texture[i] == kNoTexture) continue;
+            if (lod == current && level.visible[i]) continue;
+
+            // A texture shared by identical tiles is freed with its last user.
+            const auto handle = level.texture[i];
+            if (!tiles_->Evict(level.Id(i))) continue;
+            freed += sizes_[handle - 1];
+            SetResident(handle, 0);
+            textures_[handle - 1] = Texture2D {};
+            free_handles_.emplace_back(handle);
+        }
+        if (freed >= bytes) break;
+    }
+    return freed;
+}
+
+auto TileTextures::Bind(TextureHandle handle) -> void {
+    if (handle == kNoTexture) return;
+    textures_[handle - 1].Bind();
+}
+
+auto TileTextures::GetHandle(const TileId& id) -> TextureHandle {
+    auto& level = tiles_->GetLevel(id.lod);
+    auto& handle = level.texture[level.Index(id)];
+    if (handle == kNoTexture && !free_handles_.empty()) {
+        handle = free_handles_.back();
+        free_handles_.pop_back();
+    } else if (handle == kNoTexture) {
+        textures_.emplace_back();
+        sizes_.emplace_back(0);
+        handle = static_cast<TextureHandle>(textures_.size());
+    }
+    return handle;
+}
+
+auto TileTextures::HasPendingWork() const -> bool {
+    return !upload_queue_.empty() ||
+           !mipmap_queue_.empty() ||
+           (uploader_ != nullptr && uploader_->InFlight() > 0);
+}
+
+auto TileTextures::Debug(const OrthographicCamera& camera) const -> void {
+    auto camera_scale = glm::length(glm::vec3 {camera.transform[0]});
+    const auto stats = tiles_->GetStats();
+
+    ImGui::SetNextWindowFocus();
+    ImGui::Begin("Tile Manager");
+    ImGui::Text("Texture size: %d", static_cast<int>(tiles_->TextureDims().height));
+    ImGui::Text("Current LOD: %d", stats.current_lod);
+    ImGui::Text("Camera size: %.2f", camera.Width() * camera_scale);
+
+    const auto pool = BufferPool::Get().GetStats();
+    ImGui::Separator();
+    ImGui::Text("Buffer pool: %.1f MB reserved", pool.bytes_reserved / (1024.0 * 1024.0));
+    for (const auto& size_class : pool.classes) {
+        ImGui::Text(
+            "  %5zu KB: %zu in use, %zu cached (%zu hits, %zu misses)",
+            size_class.slab_size / 1024,
+            size_class.slabs_in_use,
+            size_class.slabs_cached,
+            size_class.hits,
+            size_class.misses
+        );
+    }
+    ImGui::Text("  Oversize: %zu in use", pool.oversize_in_use);
+
+    ImGui::Separator();
+    ImGui::Text(
+        "Load queues: %zu I/O, %zu decode, %zu ready",
+        stats.pipeline.io_queued,
+        stats.pipeline.decode_queued,
+        stats.pipeline.ready_queued
+    );
+    if (uploader_ != nullptr) {
+        ImGui::Text("Upload thread: %zu in flight", uploader_->InFlight());
+    } else {
+        ImGui::Text("Upload queue: %zu", upload_queue_.size());
+    }
+    ImGui::Text("Shared textures: %d tiles", stats.shared_tiles);
+
+    ImGui::End();
+}
@@ -0,0 +1,74 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "core/frame_governor.h"
+#include "core/orthographic_camera.h"
+#include "core/texture2d.h"
+#include "core/upload_thread.h"
+#include "tile.h"
+#include "tile_manager.h"
+
+// Owns the GL textures behind tile texture handles. Tiles the manager has
+// decoded are uploaded within the frame's budget, or on a shared-context
+// upload thread when one is attached, and marked Loaded once they can be drawn.
+class TileTextures {
+public:
+    explicit TileTextures(TileManager* tiles) : tiles_(tiles) {}
+
+    // Without an upload thread, or while its queue is full, uploads happen
+    // on the render thread.
+    auto SetUploadThread(UploadThread* uploader) -> void;
+
+    // Uploads decoded tiles and generates deferred mipmaps within the budget,
+    // and adopts textures the upload thread has finished.
+    auto Update(const UploadBudget& budget) -> void;
+
+    auto Bind(TextureHandle handle) -> void;
+
+    // Frees the textures of tiles that are not drawn, finest LODs furthest
+    // from the current one first, until `bytes` are released. The coarsest
+    // LOD stays resident so that every view has something to show. Returns
+    // the bytes freed.
+    auto Evict(std::size_t bytes) -> std::size_t;
+
+    // Base-level bytes of the uploaded textures.
+    [[nodiscard]] auto ResidentBytes() const -> std::size_t {
+        return resident_bytes_;
+    }
+
+    [[nodiscard]] auto HasPendingWork() const -> bool;
+
+    auto Debug(const OrthographicCamera& camera) const -> void;
+
+private:
+    TileManager* tiles_ {nullptr};
+
+    UploadThread* uploader_ {nullptr};
+
+    // Indexed by texture handle minus one.
+    std::vector<Texture2D> textures_;
+    std::vector<std::size_t> sizes_;
+
+    // Handles of evicted textures, reused before textures_ grows.
+    std::vector<TextureHandle> free_handles_;
+
+    std::size_t resident_bytes_ {0};
+
+    // Decoded tiles waiting for a texture upload, and uploaded tiles still
+    // sampling their base level until mipmaps are generated.
+    std::deque<TileId> upload_queue_;
+    std::deque<TileId> mipmap_queue_;
+
+    // Returns the tile's texture handle, allocating one on first use.
+    auto GetHandle(const TileId& id) -> TextureHandle;
+
+    auto ProcessUploads(const UploadBudget& budget) -> void;
+
+    auto SetResident(TextureHandle handle, std::size_t bytes) -> void;
+};
@@ -0,0 +1,192 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+// Writes the manifest of a local pyramid: which tiles exist, which are a
+// single solid colour, and which are byte-identical copies of another
+// tile. Every tile is read and decoded once, on every core. The copies
+// stay on disk: the generator, the tile server and readers without the
+// manifest still open them by their own path.
+//
+// Usage: build_manifest --width 8192 --height 8192 [--root assets/tiles]
+//                       [--tile-size 1024] [--lods 4]
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <print>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "loaders/image_loader.h"
+#include "sources/file_tile_source.h"
+#include "sources/pyramid_manifest.h"
+
+namespace fs = std::filesystem;
+
+enum class TileKind : std::uint8_t {
+    kMissing,
+    kPresent,
+    kSolid
+};
+
+struct Scanned {
+    TileId id;
+    TileKind kind {TileKind::kMissing};
+    std::uint32_t color {0};
+
+    // FNV-1a of the file's bytes, and their count.
+    std::uint64_t hash {0};
+    std::size_t size {0};
+};
+
+static auto fnv1a(std::span<const unsigned char> bytes) -> std::uint64_t {
+    auto hash = std::uint64_t {14695981039346656037ull};
+    for (const auto byte : bytes) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static auto sameBytes(const fs::path& a, const fs::path& b) -> bool {
+    const auto left = BlockingFileReader::Read(a);
+    const auto right = BlockingFileReader::Read(b);
+    return left && right && left->size == right->size &&
+           std::memcmp(left->bytes.get(), right->bytes.get(), left->size) == 0;
+}
+
+static auto parseInt(std::string_view value, int& out) -> bool {
+    const auto [ptr, error] = std::from_chars(value.data(), value.data() + value.size(), out);
+    return error == std::errc {} && ptr == value.data() + value.size();
+}
+
+auto main(int argc, char** argv) -> int {
+    auto root = fs::path {"assets/tiles"};
+    auto geometry = PyramidManifest::Geometry {.tile_size = 1024, .lods = 4};
+
+    for (auto i = 1; i < argc; i += 2) {
+        const auto arg = std::string_view {argv[i]};
+        const auto value = std::string_view {i + 1 < argc ? argv[i + 1] : ""};
+        auto valid = true;
+        if (arg == "--root") root = value;
+        else if (arg == "--width") valid = parseInt(value, geometry.width);
+        else if (arg == "--height") valid = parseInt(value, geometry.height);
+        else if (arg == "--tile-size") valid = parseInt(value, geometry.tile_size);
+        else if (arg == "--lods") valid = parseInt(value, geometry.lods);
+        else valid = false;
+
+        if (!valid) {
+            std::println("Invalid argument '{} {}'", arg, value);
+            return 1;
+        }
+    }
+    if (geometry.width <= 0 || geometry.height <= 0 || geometry.tile_size <= 0 || geometry.lods <= 0) {
+        std::println("Usage: build_manifest --width <px> --height <px> [--root <dir>] [--tile-size <px>] [--lods <n>]");
+        return 1;
+    }
+
+    auto manifest = PyramidManifest {geometry};
+    const auto source_files = FileTileSource {{.root = root, .use_manifest = false}};
+    const auto loader = ImageLoader::Create();
+
+    auto tiles = std::vector<Scanned> {};
+    for (auto lod = 0u; lod < static_cast<unsigned>(geometry.lods); ++lod) {
+        for (auto y = 0; y < manifest.TilesY(lod); ++y) {
+            for (auto x = 0; x < manifest.TilesX(lod); ++x) {
+                tiles.emplace_back(Scanned {.id = {lod, x, y}});
+            }
+        }
+    }
+
+    auto next = std::atomic<std::size_t> {0};
+    {
+        auto workers = std::vector<std::jthread> {};
+        const auto count = std::max(1u, std::thread::hardware_concurrency());
+        for (auto i = 0u; i < count; ++i) {
+            workers.emplace_back([&] {
+                for (auto index = next++; index < tiles.size(); index = next++) {
+                    auto& tile = tiles[index];
+                    const auto path = source_files.Locate(tile.id);
+                    auto error = std::error_code {};
+                    if (!fs::exists(path, error)) continue;
+
+                    const auto data = loader->Read(path);
+                    if (!data) continue;
+
+                    tile.kind = TileKind::kPresent;
+                    tile.hash = fnv1a(data->Bytes());
+                    tile.size = data->size;
+                    if (auto image = loader->Decode(data.value(), path)) {
+                        if (const auto color = PyramidManifest::SolidColorOf(*image.value())) {
+                            tile.kind = TileKind::kSolid;
+                            tile.color = color.value();
+                        }
+                    }
+                }
+            });
+        }
+    }
+
+    auto counts = std::array<std::size_t, 3> {};
+    for (const auto& tile : tiles) {
+        ++counts[static_cast<std::size_t>(tile.kind)];
+        if (tile.kind == TileKind::kPresent) manifest.MarkPresent(tile.id);
+        if (tile.kind == TileKind::kSolid) manifest.MarkSolid(tile.id, tile.color);
+    }
+
+    // Tiles are grouped by hash and size, and joined only after their bytes
+    // compare equal, so a hash collision costs a read but never a wrong tile.
+    auto candidates = std::map<std::pair<std::uint64_t, std::size_t>, std::vector<const Scanned*>> {};
+    for (const auto& tile : tiles) {
+        if (tile.kind == TileKind::kPresent) candidates[{tile.hash, tile.size}].emplace_back(&tile);
+    }
+
+    auto duplicates = std::size_t {0};
+    for (auto& [key, members] : candidates) {
+        while (members.size() > 1) {
+            const auto source = members.front()->id;
+            const auto source_path = source_files.Locate(source);
+
+            auto same = std::vector<const Scanned*> {};
+            auto rest = std::vector<const Scanned*> {};
+            for (auto* member : members) {
+                const auto matches = member == members.front() ||
+                    sameBytes(source_path, source_files.Locate(member->id));
+                (matches ? same : rest).emplace_back(member);
+            }
+
+            if (same.size() > 1) {
+                const auto group = manifest.AddGroup(source);
+                for (const auto* member : same) {
+                    manifest.MarkDuplicate(member->id, group);
+                }
+                duplicates += same.size() - 1;
+            }
+            members = std::move(rest);
+        }
+    }
+
+    if (auto saved = manifest.Save(root / PyramidManifest::kFileName); !saved) {
+        std::println("{}", saved.error());
+        return 1;
+    }
+    std::println(
+        "{} tiles: {} missing, {} solid, {} duplicates in {} groups, {} to stream",
+        tiles.size(),
+        counts[0],
+        counts[2],
+        duplicates,
+        manifest.GroupCount(),
+        counts[1] - duplicates
+    );
+    return 0;
+}
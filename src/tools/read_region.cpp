@@ -0,0 +1,141 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+// Reads a rectangle of a local pyramid at one LOD straight from its tiles,
+// without a window or GPU, and writes the pixels to a PNG. The geometry
+// comes from the pyramid's manifest when it has one.
+//
+// Usage: read_region --rect x,y,w,h [--lod 0] [--out region.png]
+//                    [--root assets/tiles] [--width 8192] [--height 8192]
+//                    [--tile-size 1024] [--lods 4]
+
+#include <array>
+#include <charconv>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "core/timer.h"
+#include "loaders/image_loader.h"
+#include "loaders/png_writer.h"
+#include "loaders/tile_cache.h"
+#include "region_reader.h"
+#include "sources/file_tile_source.h"
+
+namespace fs = std::filesystem;
+
+static auto parseInt(std::string_view value, int& out) -> bool {
+    const auto [ptr, error] = std::from_chars(value.data(), value.data() + value.size(), out);
+    return error == std::errc {} && ptr == value.data() + value.size();
+}
+
+static auto parseRect(std::string_view text) -> std::optional<RegionReader::Rect> {
+    auto values = std::array<int, 4> {};
+    for (auto& value : values) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc {}) return std::nullopt;
+        text.remove_prefix(static_cast<std::size_t>(end - text.data()));
+        if (!text.empty() && text.front() == ',') text.remove_prefix(1);
+    }
+    if (!text.empty() || values[2] <= 0 || values[3] <= 0) return std::nullopt;
+    return RegionReader::Rect {.x = values[0], .y = values[1], .width = values[2], .height = values[3]};
+}
+
+auto main(int argc, char** argv) -> int {
+    const auto timer = Timer {};
+
+    auto root = fs::path {"assets/tiles"};
+    auto output = fs::path {"region.png"};
+    auto geometry = PyramidManifest::Geometry {.width = 8192, .height = 8192, .tile_size = 1024, .lods = 4};
+    auto lod = 0;
+    auto rect = std::optional<RegionReader::Rect> {};
+
+    for (auto i = 1; i < argc; i += 2) {
+        const auto arg = std::string_view {argv[i]};
+        const auto value = std::string_view {i + 1 < argc ? argv[i + 1] : ""};
+        auto valid = true;
+        if (arg == "--root") root = value;
+        else if (arg == "--out") output = value;
+        else if (arg == "--rect") valid = (rect = parseRect(value)).has_value();
+        else if (arg == "--lod") valid = parseInt(value, lod) && lod >= 0;
+        else if (arg == "--width") valid = parseInt(value, geometry.width);
+        else if (arg == "--height") valid = parseInt(value, geometry.height);
+        else if (arg == "--tile-size") valid = parseInt(value, geometry.tile_size);
+        else if (arg == "--lods") valid = parseInt(value, geometry.lods);
+        else valid = false;
+
+        if (!valid) {
+            std::println("Invalid argument '{} {}'", arg, value);
+            return 1;
+        }
+    }
+    if (!rect) {
+        std::println("Usage: read_region --rect x,y,w,h [--lod <n>] [--out <png>] [--root <dir>]");
+        return 1;
+    }
+
+    const auto source = std::make_shared<FileTileSource>(FileTileSource::Parameters {.root = root});
+    if (const auto manifest = source->Manifest()) geometry = manifest->GetGeometry();
+    if (!geometry.IsValid()) {
+        std::println(
+            "Invalid pyramid {}x{} with {} px tiles and {} LODs",
+            geometry.width,
+            geometry.height,
+            geometry.tile_size,
+            geometry.lods
+        );
+        return 1;
+    }
+    if (lod >= geometry.lods) {
+        std::println("LOD {} is past the pyramid's {} levels", lod, geometry.lods);
+        return 1;
+    }
+
+    auto reader = RegionReader {
+        source,
+        ImageLoader::Create(),
+        std::make_shared<TileCache>(),
+        geometry,
+        RegionReader::Config {}
+    };
+
+    const auto format = reader.GetFormat();
+    if (!format) {
+        std::println("{}", format.error());
+        return 1;
+    }
+    if (format->bit_depth != 8) {
+        std::println("Only 8-bit pyramids can be written as PNG");
+        return 1;
+    }
+
+    auto pixels = std::vector<unsigned char>(
+        static_cast<std::size_t>(rect->width) * rect->height * format->BytesPerPixel()
+    );
+    if (auto result = reader.ReadRegion(static_cast<unsigned>(lod), rect.value(), pixels); !result) {
+        std::println("{}", result.error());
+        return 1;
+    }
+
+    auto writer = PngWriter::Open(
+        output,
+        static_cast<std::uint32_t>(rect->width),
+        static_cast<std::uint32_t>(rect->height),
+        format->depth
+    );
+    if (!writer) {
+        std::println("{}", writer.error());
+        return 1;
+    }
+    writer->WriteRows(pixels);
+    if (auto result = writer->Finish(); !result) {
+        std::println("{}", result.error());
+        return 1;
+    }
+
+    std::println("Read {}x{} pixels into {} in {} ms", rect->width, rect->height, output.string(), timer.GetMilliseconds());
+    return 0;
+}
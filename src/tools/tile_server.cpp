@@ -0,0 +1,215 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+// A local stand-in for a production tile server. Serves files from a
+// directory over HTTP/1.1 with keep-alive, pipelining and Range support,
+// and can inject per-request latency and a per-connection bandwidth cap so
+// that the HTTP tile source can be exercised under realistic conditions.
+//
+// Usage: tile_server [--root assets/tiles] [--prefix /tiles] [--port 8080]
+//                    [--latency-ms 0] [--bandwidth-kbps 0]
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+struct ServerConfig {
+    fs::path root {"assets/tiles"};
+    std::string prefix {"/tiles"};
+    int port {8080};
+    int latency_ms {0};
+    int bandwidth_kbps {0};
+};
+
+static auto sendAll(int socket, std::string_view data, const ServerConfig& config) -> bool {
+    // Throttled connections send in small slices and sleep off the time each
+    // slice would take at the configured rate.
+    const auto slice = config.bandwidth_kbps > 0 ? std::size_t {16 * 1024} : data.size();
+    while (!data.empty()) {
+        const auto count = std::min(slice, data.size());
+        const auto sent = send(socket, data.data(), count, 0);
+        if (sent <= 0) return false;
+        data.remove_prefix(static_cast<std::size_t>(sent));
+
+        if (config.bandwidth_kbps > 0) {
+            const auto seconds = static_cast<double>(sent) / (config.bandwidth_kbps * 1024.0);
+            std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        }
+    }
+    return true;
+}
+
+static auto readFile(const fs::path& path) -> std::optional<std::string> {
+    auto file = std::ifstream {path, std::ios::binary};
+    if (!file) return std::nullopt;
+    return std::string {std::istreambuf_iterator<char> {file}, {}};
+}
+
+// The first and last byte of a "Range: bytes=first-[last]" header, with an
+// open end as the largest size_t.
+static auto parseRange(std::string_view request) -> std::optional<std::pair<std::size_t, std::size_t>> {
+    const auto start = request.find("Range: bytes=");
+    if (start == std::string_view::npos) return std::nullopt;
+    auto spec = request.substr(start + 13);
+    spec = spec.substr(0, spec.find("\r\n"));
+
+    const auto end = spec.data() + spec.size();
+    auto first = std::size_t {0};
+    const auto [dash, first_error] = std::from_chars(spec.data(), end, first);
+    if (first_error != std::errc {} || dash == end || *dash != '-') return std::nullopt;
+    if (dash + 1 == end) return std::pair {first, std::numeric_limits<std::size_t>::max()};
+
+    auto last = std::size_t {0};
+    const auto [last_end, last_error] = std::from_chars(dash + 1, end, last);
+    if (last_error != std::errc {} || last_end != end || last < first) return std::nullopt;
+    return std::pair {first, last};
+}
+
+static auto handleRequest(int socket, std::string_view request, const ServerConfig& config) -> bool {
+    const auto line = request.substr(0, request.find("\r\n"));
+    const auto method_end = line.find(' ');
+    const auto target_end = line.find(' ', method_end + 1);
+    const auto target = line.substr(method_end + 1, target_end - method_end - 1);
+    const auto keep_alive = !request.contains("Connection: close");
+
+    if (config.latency_ms > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds {config.latency_ms});
+    }
+
+    auto body = std::optional<std::string> {};
+    if (line.starts_with("GET ") && target.starts_with(config.prefix) && !target.contains("..")) {
+        body = readFile(config.root / fs::path {target.substr(config.prefix.size())}.relative_path());
+    }
+
+    if (!body) {
+        const auto response = std::format(
+            "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n{}\r\n",
+            keep_alive ? "" : "Connection: close\r\n"
+        );
+        return sendAll(socket, response, config) && keep_alive;
+    }
+
+    auto status = std::string_view {"200 OK"};
+    auto content = std::string_view {*body};
+    auto content_range = std::string {};
+
+    // Only "first-" and "first-last" are understood; other specs are
+    // ignored and the whole file is sent, as RFC 9110 allows.
+    if (const auto range = parseRange(request)) {
+        const auto [first, requested_last] = range.value();
+        if (first >= body->size()) {
+            const auto response = std::format(
+                "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */{}\r\nContent-Length: 0\r\n{}\r\n",
+                body->size(),
+                keep_alive ? "" : "Connection: close\r\n"
+            );
+            return sendAll(socket, response, config) && keep_alive;
+        }
+        const auto last = std::min(requested_last, body->size() - 1);
+        status = "206 Partial Content";
+        content = content.substr(first, last - first + 1);
+        content_range = std::format("Content-Range: bytes {}-{}/{}\r\n", first, last, body->size());
+    }
+
+    const auto header = std::format(
+        "HTTP/1.1 {}\r\nContent-Type: image/png\r\nContent-Length: {}\r\n{}{}\r\n",
+        status,
+        content.size(),
+        content_range,
+        keep_alive ? "" : "Connection: close\r\n"
+    );
+
+    return sendAll(socket, header, config) && sendAll(socket, content, config) && keep_alive;
+}
+
+static auto serveConnection(int socket, ServerConfig config) -> void {
+    auto buffer = std::string {};
+    char chunk[16 * 1024];
+
+    // Pipelined requests are answered in order as they are parsed.
+    auto open = true;
+    while (open) {
+        auto end = buffer.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            const auto count = recv(socket, chunk, sizeof(chunk), 0);
+            if (count <= 0) break;
+            buffer.append(chunk, static_cast<std::size_t>(count));
+            continue;
+        }
+        const auto request = buffer.substr(0, end + 4);
+        buffer.erase(0, end + 4);
+        open = handleRequest(socket, request, config);
+    }
+
+    close(socket);
+}
+
+static auto parseArguments(int argc, char** argv) -> ServerConfig {
+    auto config = ServerConfig {};
+    for (auto i = 1; i + 1 < argc; i += 2) {
+        const auto key = std::string_view {argv[i]};
+        const auto value = std::string_view {argv[i + 1]};
+        const auto parseInt = [&](int& out) {
+            std::from_chars(value.data(), value.data() + value.size(), out);
+        };
+        if (key == "--root") config.root = value;
+        else if (key == "--prefix") config.prefix = value;
+        else if (key == "--port") parseInt(config.port);
+        else if (key == "--latency-ms") parseInt(config.latency_ms);
+        else if (key == "--bandwidth-kbps") parseInt(config.bandwidth_kbps);
+    }
+    return config;
+}
+
+auto main(int argc, char** argv) -> int {
+    const auto config = parseArguments(argc, argv);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    const auto server = socket(AF_INET, SOCK_STREAM, 0);
+    auto enable = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    auto address = sockaddr_in {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(config.port));
+
+    if (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(server, 64) != 0) {
+        std::println("Failed to listen on port {}", config.port);
+        return 1;
+    }
+
+    std::println(
+        "Serving {} at http://localhost:{}{} (latency {} ms, bandwidth {} KB/s)",
+        config.root.string(),
+        config.port,
+        config.prefix,
+        config.latency_ms,
+        config.bandwidth_kbps
+    );
+
+    while (true) {
+        const auto client = accept(server, nullptr, nullptr);
+        if (client < 0) continue;
+        std::thread(serveConnection, client, config).detach();
+    }
+}
@@ -23,6 +23,11 @@ struct Box2 {
         };
     }
 
+    auto Contains(const glm::vec2& point) const {
+        return point.x >= min.x && point.x <= max.x &&
+               point.y >= min.y && point.y <= max.y;
+    }
+
     auto Intersects(const Box2& other) const {
         return (min.x <= other.max.x && max.x >= other.min.x) &&
                (min.y <= other.max.y && max.y >= other.min.y);
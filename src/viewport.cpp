@@ -0,0 +1,41 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "viewport.h"
+
+#include <glad/glad.h>
+
+static auto makeCamera(const Box2& region, const Dimensions& image_dims) -> OrthographicCamera {
+    const auto size = region.max - region.min;
+    const auto width = image_dims.width;
+    const auto height = width * size.y / size.x;
+    return OrthographicCamera {0.0f, width, height, 0.0f, -1.0f, 1.0f};
+}
+
+Viewport::Viewport(const Box2& region, const Dimensions& image_dims) :
+    region_(region),
+    camera_(makeCamera(region, image_dims)),
+    controls_(&camera_)
+{
+    controls_.SetRegion(region);
+}
+
+auto Viewport::Bind(const Dimensions& window_dims, float scale) const -> void {
+    // GL counts rows from the bottom.
+    glViewport(
+        static_cast<GLint>(region_.min.x * scale),
+        static_cast<GLint>((window_dims.height - region_.max.y) * scale),
+        static_cast<GLsizei>((region_.max.x - region_.min.x) * scale),
+        static_cast<GLsizei>((region_.max.y - region_.min.y) * scale)
+    );
+}
+
+auto Viewport::Link(std::span<const std::unique_ptr<Viewport>> viewports) -> void {
+    for (const auto& leader : viewports) {
+        if (!leader->IsMoving()) continue;
+        for (const auto& viewport : viewports) {
+            viewport->controls_.SyncFrom(leader->controls_);
+        }
+        return;
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "core/orthographic_camera.h"
+#include "resources/zoom_pan_camera.h"
+#include "tile.h"
+#include "tile_manager.h"
+#include "types.h"
+
+// A camera and its controls drawing into one rectangle of the window.
+// Viewports share the tile manager and its textures, so a tile that
+// several of them show is decoded and uploaded once; each keeps only its
+// own render list.
+class Viewport {
+public:
+    // The region is in window coordinates with the origin at the top left,
+    // like mouse events. The camera starts out fitting the image's width.
+    Viewport(const Box2& region, const Dimensions& image_dims);
+
+    Viewport(const Viewport&) = delete;
+    Viewport& operator=(const Viewport&) = delete;
+
+    auto Update() -> void {
+        controls_.Update();
+    }
+
+    [[nodiscard]] auto IsMoving() const -> bool {
+        return controls_.IsMoving();
+    }
+
+    // Makes the region the GL draw target. The scale converts window
+    // coordinates to framebuffer pixels.
+    auto Bind(const Dimensions& window_dims, float scale) const -> void;
+
+    [[nodiscard]] auto GetView() const -> TileManager::View {
+        return {.camera = &camera_, .width = region_.max.x - region_.min.x};
+    }
+
+    [[nodiscard]] auto Camera() const -> const OrthographicCamera& {
+        return camera_;
+    }
+
+    auto RenderList() -> std::vector<RenderTile>& {
+        return render_list_;
+    }
+
+    // Moves every viewport to the view of the first one the user moved.
+    static auto Link(std::span<const std::unique_ptr<Viewport>> viewports) -> void;
+
+private:
+    Box2 region_;
+
+    OrthographicCamera camera_;
+    ZoomPanCamera controls_;
+
+    std::vector<RenderTile> render_list_;
+};
@@ -0,0 +1,608 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#include "virtual_texture.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <print>
+#include <utility>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <imgui.h>
+
+#include "core/uniform_blocks.h"
+
+#include "shaders/headers/vt_feedback_frag.h"
+#include "shaders/headers/vt_frag.h"
+#include "shaders/headers/vt_vert.h"
+
+// Keys order tiles by LOD, then row, then column.
+static auto packKey(const TileId& id) -> std::uint64_t {
+    return (static_cast<std::uint64_t>(id.lod) << 48) |
+           (static_cast<std::uint64_t>(id.y) << 24) |
+           static_cast<std::uint64_t>(id.x);
+}
+
+static auto unpackKey(std::uint64_t key) -> TileId {
+    return {
+        static_cast<unsigned>(key >> 48),
+        static_cast<int>(key & 0xFFFFFF),
+        static_cast<int>((key >> 24) & 0xFFFFFF)
+    };
+}
+
+VirtualTexture::VirtualTexture(
+    TileManager* tiles,
+    const Dimensions& window_dims,
+    const Config& config
+) :
+    tiles_(tiles),
+    config_(config),
+    image_dims_(tiles->TextureDims()),
+    tile_size_(tiles->TileSize()),
+    max_lod_(tiles->LodCount() - 1),
+    feedback_width_(std::max(1, static_cast<int>(window_dims.width) / config.feedback_divisor)),
+    feedback_height_(std::max(1, static_cast<int>(window_dims.height) / config.feedback_divisor)),
+    quad_({
+        .width = image_dims_.width,
+        .height = image_dims_.height,
+        .width_segments = 1,
+        .height_segments = 1
+    }),
+    shader_({
+        {ShaderType::kVertexShader, _SHADER_vt_vert},
+        {ShaderType::kFragmentShader, _SHADER_vt_frag}
+    }),
+    feedback_shader_({
+        {ShaderType::kVertexShader, _SHADER_vt_vert},
+        {ShaderType::kFragmentShader, _SHADER_vt_feedback_frag}
+    }),
+    uniforms_(GL_UNIFORM_BUFFER, 4 * 1024)
+{
+    model_ = glm::translate(
+        glm::mat4 {1.0f},
+        glm::vec3 {image_dims_.width / 2.0f, image_dims_.height / 2.0f, 0.0f}
+    );
+
+    slots_.resize(static_cast<std::size_t>(config_.slots_x) * config_.slots_y);
+
+    SetStaticUniforms(shader_);
+    SetStaticUniforms(feedback_shader_);
+    feedback_shader_.SetUniform("u_LodBias", -std::log2(static_cast<float>(config_.feedback_divisor)));
+    shader_.SetUniform("u_LodBias", 0.0f);
+    shader_.SetUniform("u_CacheSlots", glm::vec2(config_.slots_x, config_.slots_y));
+    shader_.SetUniform("u_Cache", 0);
+    shader_.SetUniform("u_PageTable", 1);
+
+    CreatePageTable();
+    CreateCache();
+    CreateFeedbackTargets();
+
+    // Pages can only point at cache slots, and each slot belongs to one
+    // tile, so solid and duplicate tiles take slots of their own.
+    tiles_->ExpandSolidTiles();
+    tiles_->DisableTextureSharing();
+
+    // The coarsest LOD is always wanted, so every pixel has a fallback.
+    const auto& coarsest = tiles_->GetLevel(max_lod_);
+    for (auto i = std::size_t {0}; i < coarsest.Size(); ++i) {
+        wanted_.emplace_back(coarsest.Id(i));
+    }
+}
+
+auto VirtualTexture::Create(
+    TileManager* tiles,
+    const Dimensions& window_dims,
+    Config config
+) -> std::unique_ptr<VirtualTexture> {
+    // Grown towards a square, which keeps both sides of the cache texture
+    // as far under the limit as they can be.
+    const auto pinned = tiles->GetLevel(tiles->LodCount() - 1).Size();
+    const auto needed = pinned + kMinFreeSlots;
+    if (static_cast<std::size_t>(config.slots_x) * config.slots_y < needed) {
+        const auto side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(needed))));
+        config.slots_x = std::max(config.slots_x, side);
+        config.slots_y = static_cast<int>((needed + config.slots_x - 1) / config.slots_x);
+    }
+
+    auto max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    const auto tile = static_cast<int>(tiles->TileSize());
+    if (config.slots_x > max_size / tile || config.slots_y > max_size / tile) {
+        std::println("A virtual texture cache cannot hold the {} tiles of the coarsest LOD", pinned);
+        return nullptr;
+    }
+
+    return std::unique_ptr<VirtualTexture>(new VirtualTexture(tiles, window_dims, config));
+}
+
+auto VirtualTexture::CreatePageTable() -> void {
+    // Level sizes halve from a power of two no smaller than 2^max_lod, so
+    // level L always has room for the ceil(tiles / 2^L) tiles of LOD L.
+    const auto& base = tiles_->GetLevel(0);
+    const auto min_size = 1u << max_lod_;
+    const auto width = static_cast<int>(std::max(std::bit_ceil(static_cast<unsigned>(base.TilesX())), min_size));
+    const auto height = static_cast<int>(std::max(std::bit_ceil(static_cast<unsigned>(base.TilesY())), min_size));
+
+    glGenTextures(1, &page_table_);
+    glBindTexture(GL_TEXTURE_2D, page_table_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(max_lod_));
+
+    for (auto lod = 0u; lod <= max_lod_; ++lod) {
+        auto& level = pages_.emplace_back();
+        level.width = std::max(1, width >> lod);
+        level.height = std::max(1, height >> lod);
+        level.entries.resize(static_cast<std::size_t>(level.width) * level.height);
+        glTexImage2D(
+            GL_TEXTURE_2D,
+            static_cast<int>(lod),
+            GL_RGBA8UI,
+            level.width,
+            level.height,
+            0,
+            GL_RGBA_INTEGER,
+            GL_UNSIGNED_BYTE,
+            level.entries.data()
+        );
+    }
+}
+
+auto VirtualTexture::CreateCache() -> void {
+    const auto tile = static_cast<int>(tile_size_);
+
+    glGenTextures(1, &cache_);
+    glBindTexture(GL_TEXTURE_2D, cache_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(
+        GL_TEXTURE_2D,
+        0,
+        GL_RGBA8,
+        config_.slots_x * tile,
+        config_.slots_y * tile,
+        0,
+        GL_RGBA,
+        GL_UNSIGNED_BYTE,
+        nullptr
+    );
+}
+
+auto VirtualTexture::CreateFeedbackTargets() -> void {
+    glGenRenderbuffers(1, &feedback_target_);
+    glBindRenderbuffer(GL_RENDERBUFFER, feedback_target_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA16UI, feedback_width_, feedback_height_);
+
+    glGenFramebuffers(1, &feedback_fbo_);
+    glBindFramebuffer(GL_FRAMEBUFFER, feedback_fbo_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, feedback_target_);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::println("Virtual texture feedback framebuffer is incomplete");
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    const auto bytes = static_cast<std::size_t>(feedback_width_) * feedback_height_ * 4 * sizeof(std::uint16_t);
+    glGenBuffers(static_cast<int>(kReadbackDepth), pbos_.data());
+    for (auto pbo : pbos_) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+auto VirtualTexture::RenderFeedback(const OrthographicCamera& camera) -> void {
+    const auto view_projection = camera.projection * camera.View();
+    if (view_projection != feedback_view_) feedback_dirty_ = true;
+    if (!feedback_dirty_ || readback_count_ == kReadbackDepth) return;
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, feedback_fbo_);
+    glViewport(0, 0, feedback_width_, feedback_height_);
+    const GLuint clear[4] {0, 0, 0, 0};
+    glClearBufferuiv(GL_COLOR, 0, clear);
+
+    BindCamera(camera);
+    quad_.Draw(feedback_shader_);
+    uniforms_.EndFrame();
+
+    // The copy into the pixel buffer is queued behind the draw; the fence
+    // tells Update() when it can be mapped without stalling.
+    const auto index = (readback_head_ + readback_count_) % kReadbackDepth;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos_[index]);
+    glReadPixels(0, 0, feedback_width_, feedback_height_, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    fences_[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    ++readback_count_;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    feedback_view_ = view_projection;
+    feedback_dirty_ = false;
+}
+
+auto VirtualTexture::Update(const UploadBudget& budget) -> void {
+    // Readbacks finish in order, and only the newest finished one matters.
+    auto latest = kReadbackDepth;
+    while (readback_count_ > 0) {
+        auto& fence = fences_[readback_head_];
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) break;
+        glDeleteSync(fence);
+        fence = nullptr;
+        latest = readback_head_;
+        readback_head_ = (readback_head_ + 1) % kReadbackDepth;
+        --readback_count_;
+    }
+    if (latest != kReadbackDepth) ReadFeedback(latest);
+
+    // Every tile that arrives takes a slot. Asking for more than the cache
+    // can free would only load tiles that are dropped on arrival, or that
+    // evict each other while still wanted, so requests stop at the slots
+    // not already promised to loads in flight.
+    const auto promised = static_cast<std::size_t>(tiles_->GetStats().pending_loads) + upload_queue_.size();
+    const auto available = AvailableSlots();
+    const auto room = available - std::min(available, promised);
+    const auto unloaded = [this](const TileId& id) {
+        const auto& level = tiles_->GetLevel(id.lod);
+        return level.state[level.Index(id)] == TileState::Unloaded;
+    };
+
+    requests_.clear();
+    std::ranges::copy_if(wanted_, std::back_inserter(requests_), unloaded);
+
+    // While they do not fit, the parents are asked for instead, a level at
+    // a time: each covers four tiles with one slot, so the whole view
+    // settles on a coarser LOD rather than part of it thrashing.
+    while (requests_.size() > room && std::ranges::any_of(requests_, [this](const TileId& id) { return id.lod < max_lod_; })) {
+        for (auto& id : requests_) {
+            if (id.lod < max_lod_) id = {id.lod + 1, id.x / 2, id.y / 2};
+        }
+        std::ranges::sort(requests_, std::greater {}, packKey);
+        const auto duplicates = std::ranges::unique(requests_, {}, packKey);
+        requests_.erase(duplicates.begin(), duplicates.end());
+        std::erase_if(requests_, std::not_fn(unloaded));
+    }
+
+    // Coarsest first, so the pinned LOD is never cut.
+    if (requests_.size() > room) requests_.resize(room);
+
+    tiles_->Request(requests_);
+    for (const auto& id : tiles_->TakeDecoded()) {
+        upload_queue_.emplace_back(id);
+    }
+
+    ProcessUploads(budget);
+    FlushPageTable();
+}
+
+auto VirtualTexture::ReadFeedback(std::size_t index) -> void {
+    const auto count = static_cast<std::size_t>(feedback_width_) * feedback_height_;
+
+    keys_.clear();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos_[index]);
+    const auto texels = static_cast<const std::uint16_t*>(glMapBufferRange(
+        GL_PIXEL_PACK_BUFFER,
+        0,
+        static_cast<GLsizeiptr>(count * 4 * sizeof(std::uint16_t)),
+        GL_MAP_READ_BIT
+    ));
+    if (texels != nullptr) {
+        for (auto i = std::size_t {0}; i < count; ++i) {
+            const auto texel = texels + i * 4;
+            if (texel[3] == 0) continue;
+            const auto key = packKey({texel[2], texel[0], texel[1]});
+            // Neighbouring pixels mostly want the same tile.
+            if (keys_.empty() || keys_.back() != key) keys_.emplace_back(key);
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Coarsest first, so fallbacks are requested before the tiles that
+    // refine them.
+    std::ranges::sort(keys_, std::greater {});
+    keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+
+    ++generation_;
+    wanted_.clear();
+
+    const auto& coarsest = tiles_->GetLevel(max_lod_);
+    for (auto i = std::size_t {0}; i < coarsest.Size(); ++i) {
+        wanted_.emplace_back(coarsest.Id(i));
+    }
+
+    for (const auto key : keys_) {
+        const auto id = unpackKey(key);
+        if (id.lod >= max_lod_) continue;
+        const auto& level = tiles_->GetLevel(id.lod);
+        if (id.x >= level.TilesX() || id.y >= level.TilesY()) continue;
+        wanted_.emplace_back(id);
+    }
+
+    // A tile is in use if it, or the coarser tile standing in for it, is
+    // what the pixels asking for it currently sample.
+    for (const auto& id : wanted_) {
+        const auto& pages = pages_[id.lod];
+        const auto& entry = pages.entries[static_cast<std::size_t>(id.y) * pages.width + id.x];
+        if (entry.valid) {
+            slots_[static_cast<std::size_t>(entry.slot_y) * config_.slots_x + entry.slot_x].last_used = generation_;
+        }
+    }
+}
+
+auto VirtualTexture::ProcessUploads(const UploadBudget& budget) -> void {
+    auto uploads = 0;
+    auto bytes = std::size_t {0};
+    const auto tile = static_cast<int>(tile_size_);
+
+    glBindTexture(GL_TEXTURE_2D, cache_);
+
+    // The first upload of a frame always goes through, so a tile larger
+    // than the byte budget still makes progress.
+    while (!upload_queue_.empty() && uploads < budget.uploads) {
+        const auto id = upload_queue_.front();
+        auto& level = tiles_->GetLevel(id.lod);
+        const auto idx = level.Index(id);
+        if (level.state[idx] != TileState::Decoded) {
+            upload_queue_.pop_front();
+            continue;
+        }
+
+        const auto& image = level.image[idx];
+        const auto size = image->Bytes();
+        if (uploads > 0 && bytes + size > budget.bytes) break;
+        upload_queue_.pop_front();
+
+        const auto slot = AcquireSlot();
+        if (slot < 0) {
+            // The view wants more tiles than the cache holds. This one is
+            // dropped, and the coarser tile covering it stays on screen.
+            tiles_->Evict(id);
+            std::erase_if(wanted_, [&](const TileId& other) {
+                return other.lod == id.lod && other.x == id.x && other.y == id.y;
+            });
+            continue;
+        }
+
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,
+            (slot % config_.slots_x) * tile,
+            (slot / config_.slots_x) * tile,
+            static_cast<int>(image->width),
+            static_cast<int>(image->height),
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            ToRgba8(*image)
+        );
+        bytes += size;
+        ++uploads;
+
+        level.texture[idx] = static_cast<TextureHandle>(slot + 1);
+        level.image[idx] = nullptr;
+        tiles_->MarkLoaded(id);
+
+        slots_[slot] = {.id = id, .occupied = true, .last_used = generation_};
+        RefreshPages(id);
+    }
+}
+
+auto VirtualTexture::ToRgba8(const Image& image) -> const unsigned char* {
+    if (image.depth == 4 && image.bit_depth == 8) return image.Data();
+
+    const auto pixels = static_cast<std::size_t>(image.width) * image.height;
+    const auto channels = static_cast<std::size_t>(image.depth);
+    const auto narrow = image.Data();
+    const auto wide = reinterpret_cast<const std::uint16_t*>(image.Data());
+    const auto channel = [&](std::size_t i) -> unsigned char {
+        return image.bit_depth == 16 ? static_cast<unsigned char>(wide[i] >> 8) : narrow[i];
+    };
+
+    expanded_.resize(pixels * 4);
+    for (auto i = std::size_t {0}; i < pixels; ++i) {
+        const auto src = i * channels;
+        auto dst = expanded_.data() + i * 4;
+        if (channels < 3) {
+            dst[0] = dst[1] = dst[2] = channel(src);
+            dst[3] = channels == 2 ? channel(src + 1) : 255;
+        } else {
+            dst[0] = channel(src);
+            dst[1] = channel(src + 1);
+            dst[2] = channel(src + 2);
+            dst[3] = channels == 4 ? channel(src + 3) : 255;
+        }
+    }
+    return expanded_.data();
+}
+
+auto VirtualTexture::AcquireSlot() -> int {
+    auto victim = -1;
+    for (auto i = 0; std::cmp_less(i, slots_.size()); ++i) {
+        const auto& slot = slots_[i];
+        if (!slot.occupied) return i;
+        if (slot.id.lod == max_lod_ || slot.last_used >= generation_) continue;
+        if (victim < 0 || slot.last_used < slots_[victim].last_used) victim = i;
+    }
+
+    if (victim >= 0) {
+        const auto evicted = slots_[victim].id;
+        slots_[victim] = {};
+        tiles_->Evict(evicted);
+        RefreshPages(evicted);
+    }
+    return victim;
+}
+
+auto VirtualTexture::AvailableSlots() const -> std::size_t {
+    return static_cast<std::size_t>(std::ranges::count_if(slots_, [this](const Slot& slot) {
+        return !slot.occupied || (slot.id.lod != max_lod_ && slot.last_used < generation_);
+    }));
+}
+
+auto VirtualTexture::RefreshPages(const TileId& id) -> void {
+    for (auto lod = id.lod + 1; lod-- > 0;) {
+        const auto shift = id.lod - lod;
+        const auto& tiles = tiles_->GetLevel(lod);
+        const auto x0 = id.x << shift;
+        const auto y0 = id.y << shift;
+        const auto x1 = std::min((id.x + 1) << shift, tiles.TilesX());
+        const auto y1 = std::min((id.y + 1) << shift, tiles.TilesY());
+        if (x0 >= x1 || y0 >= y1) continue;
+
+        auto& pages = pages_[lod];
+        for (auto y = y0; y < y1; ++y) {
+            for (auto x = x0; x < x1; ++x) {
+                pages.entries[static_cast<std::size_t>(y) * pages.width + x] = ResolvePage(lod, x, y);
+            }
+        }
+
+        if (pages.dirty_max_x < pages.dirty_min_x) {
+            pages.dirty_min_x = x0;
+            pages.dirty_min_y = y0;
+            pages.dirty_max_x = x1 - 1;
+            pages.dirty_max_y = y1 - 1;
+        } else {
+            pages.dirty_min_x = std::min(pages.dirty_min_x, x0);
+            pages.dirty_min_y = std::min(pages.dirty_min_y, y0);
+            pages.dirty_max_x = std::max(pages.dirty_max_x, x1 - 1);
+            pages.dirty_max_y = std::max(pages.dirty_max_y, y1 - 1);
+        }
+    }
+}
+
+auto VirtualTexture::ResolvePage(unsigned lod, int x, int y) const -> PageEntry {
+    for (auto resident = lod; resident <= max_lod_; ++resident) {
+        const auto& level = tiles_->GetLevel(resident);
+        const auto shift = resident - lod;
+        const auto idx = level.Index({resident, x >> shift, y >> shift});
+        if (level.state[idx] == TileState::Loaded) {
+            const auto slot = static_cast<int>(level.texture[idx]) - 1;
+            return {
+                .slot_x = static_cast<std::uint8_t>(slot % config_.slots_x),
+                .slot_y = static_cast<std::uint8_t>(slot / config_.slots_x),
+                .lod = static_cast<std::uint8_t>(resident),
+                .valid = 1
+            };
+        }
+    }
+    return {};
+}
+
+auto VirtualTexture::FlushPageTable() -> void {
+    auto bound = false;
+    for (auto lod = 0u; lod <= max_lod_; ++lod) {
+        auto& pages = pages_[lod];
+        if (pages.dirty_max_x < pages.dirty_min_x) continue;
+
+        if (!bound) {
+            glBindTexture(GL_TEXTURE_2D, page_table_);
+            bound = true;
+        }
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, pages.width);
+        glTexSubImage2D(
+            GL_TEXTURE_2D,
+            static_cast<int>(lod),
+            pages.dirty_min_x,
+            pages.dirty_min_y,
+            pages.dirty_max_x - pages.dirty_min_x + 1,
+            pages.dirty_max_y - pages.dirty_min_y + 1,
+            GL_RGBA_INTEGER,
+            GL_UNSIGNED_BYTE,
+            &pages.entries[static_cast<std::size_t>(pages.dirty_min_y) * pages.width + pages.dirty_min_x]
+        );
+
+        pages.dirty_min_x = pages.dirty_min_y = 0;
+        pages.dirty_max_x = pages.dirty_max_y = -1;
+    }
+    if (bound) glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+auto VirtualTexture::Draw(const OrthographicCamera& camera) -> void {
+    BindCamera(camera);
+
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, page_table_);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, cache_);
+
+    quad_.Draw(shader_);
+    uniforms_.EndFrame();
+}
+
+auto VirtualTexture::BindCamera(const OrthographicCamera& camera) -> void {
+    uniforms_.BeginFrame();
+    const auto block = uniforms_.Push(
+        CameraBlock {.projection = camera.projection, .view = camera.View()},
+        StreamBuffer::UniformAlignment()
+    );
+    uniforms_.Flush();
+    glBindBufferRange(
+        GL_UNIFORM_BUFFER,
+        kCameraBlockBinding,
+        uniforms_.Id(),
+        static_cast<GLintptr>(block.offset),
+        sizeof(CameraBlock)
+    );
+}
+
+auto VirtualTexture::SetStaticUniforms(const Shaders& shader) const -> void {
+    shader.BindUniformBlock("Camera", kCameraBlockBinding);
+    shader.SetUniform("u_Model", model_);
+    shader.SetUniform("u_ImageSize", glm::vec2 {image_dims_.width, image_dims_.height});
+    shader.SetUniform("u_TileSize", tile_size_);
+    shader.SetUniform("u_MaxLod", static_cast<int>(max_lod_));
+}
+
+auto VirtualTexture::HasPendingWork() const -> bool {
+    return feedback_dirty_ ||
+           readback_count_ > 0 ||
+           !upload_queue_.empty() ||
+           tiles_->HasPendingWork();
+}
+
+auto VirtualTexture::Debug() const -> void {
+    const auto stats = tiles_->GetStats();
+    const auto resident = std::ranges::count_if(slots_, [](const Slot& slot) { return slot.occupied; });
+
+    ImGui::SetNextWindowFocus();
+    ImGui::Begin("Virtual Texture");
+    ImGui::Text("Cache: %d of %zu slots resident", static_cast<int>(resident), slots_.size());
+    ImGui::Text("Wanted tiles: %zu, %zu requested", wanted_.size(), requests_.size());
+    ImGui::Text(
+        "Feedback: %dx%d, %zu readbacks in flight",
+        feedback_width_,
+        feedback_height_,
+        readback_count_
+    );
+    ImGui::Text(
+        "Load queues: %zu I/O, %zu decode, %zu ready",
+        stats.pipeline.io_queued,
+        stats.pipeline.decode_queued,
+        stats.pipeline.ready_queued
+    );
+    ImGui::Text("Upload queue: %zu", upload_queue_.size());
+    ImGui::End();
+}
+
+VirtualTexture::~VirtualTexture() {
+    for (auto fence : fences_) {
+        if (fence != nullptr) glDeleteSync(fence);
+    }
+    glDeleteBuffers(static_cast<int>(kReadbackDepth), pbos_.data());
+    glDeleteFramebuffers(1, &feedback_fbo_);
+    glDeleteRenderbuffers(1, &feedback_target_);
+    glDeleteTextures(1, &cache_);
+    glDeleteTextures(1, &page_table_);
+}
@@ -0,0 +1,198 @@
+// Copyright © 2025 - Present, Shlomi Nissan.
+// All rights reserved.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+
+#include "core/frame_governor.h"
+#include "core/orthographic_camera.h"
+#include "core/shaders.h"
+#include "core/stream_buffer.h"
+#include "geometries/plane_geometry.h"
+#include "tile.h"
+#include "tile_manager.h"
+#include "types.h"
+
+// Draws the whole image in one call by sampling a cache texture of resident
+// tiles through a page table, and streams in the tiles the GPU reports it
+// sampled rather than the ones the camera rectangle covers.
+//
+// A low-resolution feedback pass writes the tile each pixel wants. It is
+// read back through a ring of pixel buffers a frame or two later, so the
+// render thread never waits on the GPU. The page table has a mip level per
+// LOD whose entries point at the finest resident tile covering them, so a
+// missing tile falls back to a coarser one until it arrives.
+class VirtualTexture {
+public:
+    struct Config {
+        // The cache holds slots_x * slots_y tiles. The coarsest LOD is
+        // pinned, so Create() grows a cache too small to hold it with
+        // kMinFreeSlots to spare.
+        int slots_x {4};
+        int slots_y {4};
+
+        // Feedback is rendered at 1 / feedback_divisor of the window size.
+        int feedback_divisor {8};
+    };
+
+    static constexpr std::size_t kReadbackDepth {3};
+
+    // Slots left for finer tiles once the coarsest LOD is resident.
+    static constexpr std::size_t kMinFreeSlots {16};
+
+    // Returns nullptr when the cache texture cannot grow large enough to
+    // hold the coarsest LOD, in which case tiles must be drawn another way.
+    [[nodiscard]] static auto Create(TileManager* tiles, const Dimensions& window_dims) -> std::unique_ptr<VirtualTexture> {
+        return Create(tiles, window_dims, Config {});
+    }
+
+    [[nodiscard]] static auto Create(
+        TileManager* tiles,
+        const Dimensions& window_dims,
+        Config config
+    ) -> std::unique_ptr<VirtualTexture>;
+
+    VirtualTexture(const VirtualTexture&) = delete;
+    VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+    // Renders and queues the readback of the feedback pass, but only when
+    // the view changed since the last one.
+    auto RenderFeedback(const OrthographicCamera& camera) -> void;
+
+    // Collects finished readbacks, requests the tiles they name, and copies
+    // decoded tiles into the cache within the budget.
+    auto Update(const UploadBudget& budget) -> void;
+
+    auto Draw(const OrthographicCamera& camera) -> void;
+
+    [[nodiscard]] auto HasPendingWork() const -> bool;
+
+    auto Debug() const -> void;
+
+    ~VirtualTexture();
+
+private:
+    VirtualTexture(TileManager* tiles, const Dimensions& window_dims, const Config& config);
+
+    struct Slot {
+        TileId id {};
+        bool occupied {false};
+
+        // Feedback generation that last sampled the tile.
+        std::uint64_t last_used {0};
+    };
+
+    // Matches the RGBA8UI texels of the page table.
+    struct PageEntry {
+        std::uint8_t slot_x {0};
+        std::uint8_t slot_y {0};
+        std::uint8_t lod {0};
+        std::uint8_t valid {0};
+    };
+
+    struct PageLevel {
+        int width {0};
+        int height {0};
+        std::vector<PageEntry> entries;
+
+        // Texels changed since the last upload; empty while min > max.
+        int dirty_min_x {0};
+        int dirty_min_y {0};
+        int dirty_max_x {-1};
+        int dirty_max_y {-1};
+    };
+
+    TileManager* tiles_ {nullptr};
+
+    Config config_;
+
+    Dimensions image_dims_;
+
+    float tile_size_ {0.0f};
+
+    unsigned max_lod_ {0};
+
+    int feedback_width_ {0};
+    int feedback_height_ {0};
+
+    unsigned int page_table_ {0};
+    unsigned int cache_ {0};
+    unsigned int feedback_fbo_ {0};
+    unsigned int feedback_target_ {0};
+
+    std::array<unsigned int, kReadbackDepth> pbos_ {};
+    std::array<GLsync, kReadbackDepth> fences_ {};
+    std::size_t readback_head_ {0};
+    std::size_t readback_count_ {0};
+
+    // The view the last feedback pass was rendered for.
+    glm::mat4 feedback_view_ {0.0f};
+    bool feedback_dirty_ {true};
+
+    std::uint64_t generation_ {0};
+
+    std::vector<Slot> slots_;
+    std::vector<PageLevel> pages_;
+
+    // Tiles named by the latest feedback, plus the pinned coarsest LOD.
+    std::vector<TileId> wanted_;
+
+    // The unloaded part of wanted_ that the cache has room for this frame.
+    std::vector<TileId> requests_;
+    std::vector<std::uint64_t> keys_;
+
+    std::deque<TileId> upload_queue_;
+
+    // Scratch for tiles widened to the cache format.
+    std::vector<unsigned char> expanded_;
+
+    PlaneGeometry quad_;
+    glm::mat4 model_ {1.0f};
+
+    Shaders shader_;
+    Shaders feedback_shader_;
+
+    StreamBuffer uniforms_;
+
+    auto CreatePageTable() -> void;
+
+    auto CreateCache() -> void;
+
+    auto CreateFeedbackTargets() -> void;
+
+    auto ReadFeedback(std::size_t index) -> void;
+
+    auto ProcessUploads(const UploadBudget& budget) -> void;
+
+    // The cache is RGBA8 whatever the tiles are, so other formats are
+    // widened on the way in, keeping the high byte of 16-bit channels.
+    auto ToRgba8(const Image& image) -> const unsigned char*;
+
+    // Returns a free slot, evicting the least recently sampled tile that the
+    // latest feedback did not ask for; -1 when every slot is in use.
+    auto AcquireSlot() -> int;
+
+    // Slots AcquireSlot() could hand out right now.
+    [[nodiscard]] auto AvailableSlots() const -> std::size_t;
+
+    // Rewrites the entries of the tile and every finer tile it covers.
+    auto RefreshPages(const TileId& id) -> void;
+
+    auto ResolvePage(unsigned lod, int x, int y) const -> PageEntry;
+
+    auto FlushPageTable() -> void;
+
+    auto SetStaticUniforms(const Shaders& shader) const -> void;
+
+    // Streams and binds the camera block for one pass.
+    auto BindCamera(const OrthographicCamera& camera) -> void;
+};